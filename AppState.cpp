@@ -1,17 +1,68 @@
 #include "AppState.h"
 #include "lib/CSVHelper.h"
 #include "lib/Sort.h"
+#include "lib/Snapshot.h"
+#include "lib/AtomicFile.h"
+#include "lib/Search.h"
 #include "utils/Date.h"
 #include <cstdio>
+#include <filesystem>
 
-AppState::AppState() : currentUserId(-1) {}
+static const int SNAPSHOT_VERSION = 3;
+static const char *SNAPSHOT_FILE = "npttgc.snapshot";
+static const char *CSV_FILES[] = {"members.csv", "games.csv", "borrows.csv", "reviews.csv"};
+static const int MAX_INDEXED_PLAYER_COUNT = 100;
 
+// Top-rated ranking shrinks each title's average towards this prior, as if it had
+// RATING_PRIOR_WEIGHT extra reviews at RATING_PRIOR_MEAN, so a single 5-star review can't top it
+static const double RATING_PRIOR_MEAN = 3.0;
+static const int RATING_PRIOR_WEIGHT = 5;
+static const int TRENDING_WINDOW_DAYS = 30;
+static const int LOAN_PERIOD_DAYS = 14;
+
+AppState::AppState()
+    : currentUserId(-1), gameFilter(games), recentBorrows(TRENDING_WINDOW_DAYS * DateHelper::MINUTES_PER_DAY) {}
+
+/*
+ * Loads all application data.
+ * Starts from the binary snapshot when it was built from the CSV files as they are now,
+ * otherwise parses the CSV files and writes a fresh snapshot for the next startup.
+ */
 void AppState::loadData()
 {
-    loadMembers("members.csv");
-    loadGames("games.csv");
-    loadBorrows("borrows.csv");
-    loadReviews("reviews.csv");
+    recoverInterruptedSaves();
+
+    if (loadSnapshot(SNAPSHOT_FILE))
+    {
+        return;
+    }
+
+    loadMembers(CSV_FILES[0]);
+    loadGames(CSV_FILES[1]);
+    loadBorrows(CSV_FILES[2]);
+    loadReviews(CSV_FILES[3]);
+
+    if (!saveSnapshot(SNAPSHOT_FILE))
+    {
+        printf("Warning: Could not write snapshot %s.\n", SNAPSHOT_FILE);
+    }
+}
+
+/*
+ * Cleans up after saves that were interrupted (e.g. by a crash) before their final rename.
+ * Saves only replace a file once its temporary copy is fully written and synced, so the
+ * data file itself is always complete and the leftover temporary file can be discarded.
+ */
+void AppState::recoverInterruptedSaves()
+{
+    for (const char *csvFile : CSV_FILES)
+    {
+        if (AtomicFile::recover(csvFile))
+        {
+            printf("Warning: Discarded unfinished save of %s; keeping the last complete version.\n", csvFile);
+        }
+    }
+    AtomicFile::recover(SNAPSHOT_FILE);
 }
 
 void AppState::loadMembers(const std::string &filename)
@@ -19,12 +70,14 @@ void AppState::loadMembers(const std::string &filename)
     auto buildMemberAndIndexUsername = [&](const Vector<std::string> &row)
     {
         Member m = Member::fromCSVRow(row);
-        membersByUsername.insert(m.username, m.id);
+        indexMember(m);
         return m;
     };
 
-    members = buildDictFromFile<int, Member>(
+    members.clear();
+    loadDictFromFile(
         filename,
+        members,
         buildMemberAndIndexUsername,
         [](const Member &m)
         { return m.id; });
@@ -32,9 +85,9 @@ void AppState::loadMembers(const std::string &filename)
     if (members.isEmpty())
     {
         printf("Starting with default admin account.\n");
-        Member admin(1, "admin", true);
+        Member admin(1, StringPool::global().intern("admin"), true);
         members.insert(admin.id, admin);
-        membersByUsername.insert(admin.username, admin.id);
+        indexMember(admin);
     }
 
     printf("Loaded %d members from %s\n", members.getSize(), filename.c_str());
@@ -42,12 +95,16 @@ void AppState::loadMembers(const std::string &filename)
 
 void AppState::loadGames(const std::string &filename)
 {
-    games = buildDictFromFile<int, Game>(
-        filename,
-        Game::fromCSVRow,
-        [](const Game &g)
-        { return g.id; });
+    games.clear();
+    Vector<Game> rows = buildFromFile<Game>(filename, Game::fromCSVRow);
+    for (int i = 0; i < rows.getSize(); i++)
+    {
+        games.insert(rows[i].id, rows[i]);
+        indexGameName(rows[i].id, rows[i].name);
+    }
     rebuildGameNames();
+    rebuildGamesByPlayerCount();
+    gameFilter.rebuild();
 
     printf("Loaded %d games from %s\n", games.getSize(), filename.c_str());
 }
@@ -57,26 +114,22 @@ void AppState::loadBorrows(const std::string &filename)
     auto buildBorrowAndMarkBorrowed = [&](const Vector<std::string> &row)
     {
         Borrow b = Borrow::fromCSVRow(row);
-        Vector<int> borrowIds;
-        if (borrowsByMember.exists(b.memberId))
-        {
-            borrowIds = borrowsByMember.get(b.memberId);
-        }
-        borrowIds.append(b.borrowId);
-        borrowsByMember.insert(b.memberId, borrowIds);
-        if (b.dateReturned.empty() || b.dateReturned == "N/A")
-        {
-            borrowedGames.insert(b.gameId);
-        }
+        indexBorrow(b);
         return b;
     };
 
-    borrows = buildDictFromFile<int, Borrow>(
+    borrows.clear();
+    loadDictFromFile(
         filename,
+        borrows,
         buildBorrowAndMarkBorrowed,
         [](const Borrow &b)
         { return b.borrowId; });
 
+    rebuildBorrowLog();
+    rebuildLoanIntervals();
+    rebuildRecentBorrows();
+
     printf("Loaded %d borrow records from %s\n", borrows.getSize(), filename.c_str());
 }
 
@@ -85,18 +138,14 @@ void AppState::loadReviews(const std::string &filename)
     auto buildReviewAndIndexByGame = [&](const Vector<std::string> &row)
     {
         Review r = Review::fromCSVRow(row);
-        Vector<int> reviewIds;
-        if (reviewsByGame.exists(r.gameId))
-        {
-            reviewIds = reviewsByGame.get(r.gameId);
-        }
-        reviewIds.append(r.reviewId);
-        reviewsByGame.insert(r.gameId, reviewIds);
+        indexReview(r);
         return r;
     };
 
-    reviews = buildDictFromFile<int, Review>(
+    reviews.clear();
+    loadDictFromFile(
         filename,
+        reviews,
         buildReviewAndIndexByGame,
         [](const Review &r)
         { return r.reviewId; });
@@ -104,14 +153,431 @@ void AppState::loadReviews(const std::string &filename)
     printf("Loaded %d reviews from %s\n", reviews.getSize(), filename.c_str());
 }
 
+void AppState::indexMember(const Member &member)
+{
+    membersByUsername.insert(member.username, member.id);
+}
+
+/*
+ * Sort key ordering borrows by borrow date, then by borrow id.
+ * Both are non-negative, so they pack into one 64-bit integer for radix sorting.
+ */
+static int64_t borrowTimeOrder(const Borrow &borrow)
+{
+    return ((int64_t)borrow.dateBorrowed << 32) | (uint32_t)borrow.borrowId;
+}
+
+/*
+ * Appends an id to the list stored under a key, updating the list in place.
+ * New lists start small since most keys only ever hold a few ids.
+ */
+template <typename K, template <typename> class Allocator>
+static void appendId(Dictionary<K, Vector<int>, Allocator> &index, const K &key, int id)
+{
+    Vector<int> *ids = index.find(key);
+    if (ids == nullptr)
+    {
+        index.insert(key, Vector<int>(2));
+        ids = index.find(key);
+    }
+    ids->append(id);
+}
+
+void AppState::indexBorrow(const Borrow &borrow)
+{
+    appendId(borrowsByMember, borrow.memberId, borrow.borrowId);
+    appendId(borrowsByGame, borrow.gameId, borrow.borrowId);
+    loanStatsByGame.findOrInsert(borrow.gameId).recordBorrow(borrow);
+
+    if (!borrow.isReturned())
+    {
+        borrowedGames.insert(borrow.gameId);
+        activeBorrowsByMember.findOrInsert(borrow.memberId).add(borrow.dateBorrowed, borrow.borrowId);
+        borrowsByDueTime.push(borrow.borrowId, getDueTime(borrow));
+    }
+
+    int row = games.findRow(borrow.gameId);
+    if (row != -1)
+    {
+        StringHandle title = games.view(row).name();
+        borrowCountsByTitle.findOrInsert(title)++;
+        refreshLeaderboards(title);
+    }
+}
+
+/*
+ * Records a game id under its name. Every copy is kept, deleted or not,
+ * since reviews of deleted copies still count towards the title.
+ */
+void AppState::indexGameName(int gameId, StringHandle name)
+{
+    appendId(gamesByName, name, gameId);
+}
+
+void AppState::unindexGameName(int gameId, StringHandle name)
+{
+    Vector<int> *ids = gamesByName.find(name);
+    if (ids == nullptr)
+    {
+        return;
+    }
+    for (int i = 0; i < ids->getSize(); i++)
+    {
+        if ((*ids)[i] == gameId)
+        {
+            ids->remove(i);
+            return;
+        }
+    }
+}
+
+/*
+ * Recomputes a title's rating and borrow aggregates from the per-game aggregates of every copy
+ * indexed under it, for when a copy moves to another title. A title left without ratings or
+ * borrows is taken off the matching leaderboard.
+ */
+void AppState::rebuildTitleAggregates(StringHandle title)
+{
+    RatingStats ratings;
+    int borrowCount = 0;
+    const Vector<int> *gameIds = gamesByName.find(title);
+    if (gameIds != nullptr)
+    {
+        for (int gameId : *gameIds)
+        {
+            const RatingStats *gameRatings = ratingsByGame.find(gameId);
+            if (gameRatings != nullptr)
+            {
+                ratings.merge(*gameRatings);
+            }
+            const LoanStats *loanStats = loanStatsByGame.find(gameId);
+            if (loanStats != nullptr)
+            {
+                borrowCount += loanStats->totalLoans;
+            }
+        }
+    }
+
+    if (ratings.count > 0)
+    {
+        ratingsByTitle.insert(title, ratings);
+    }
+    else
+    {
+        ratingsByTitle.remove(title);
+        topRatedGames.remove(title);
+    }
+    if (borrowCount > 0)
+    {
+        borrowCountsByTitle.insert(title, borrowCount);
+    }
+    else
+    {
+        borrowCountsByTitle.remove(title);
+        mostBorrowedGames.remove(title);
+    }
+}
+
+void AppState::indexReview(const Review &review)
+{
+    appendId(reviewsByGame, review.gameId, review.reviewId);
+    ratingsByGame.findOrInsert(review.gameId).add(review.rating);
+
+    int row = games.findRow(review.gameId);
+    if (row != -1)
+    {
+        StringHandle title = games.view(row).name();
+        ratingsByTitle.findOrInsert(title).add(review.rating);
+        refreshLeaderboards(title);
+    }
+}
+
+/*
+ * Reads the size and modification time of a CSV file, as recorded in the snapshot.
+ * A missing file is recorded as size -1 and time 0.
+ */
+static void statCSVFile(const char *csvFile, int64_t &size, int64_t &modified)
+{
+    std::error_code error;
+    std::uintmax_t fileSize = std::filesystem::file_size(csvFile, error);
+    if (error)
+    {
+        size = -1;
+        modified = 0;
+        return;
+    }
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(csvFile, error);
+    size = (int64_t)fileSize;
+    modified = error ? 0 : (int64_t)time.time_since_epoch().count();
+}
+
+/*
+ * Checks whether the snapshot was built from the CSV files as they are now.
+ * The snapshot records every CSV file's size and modification time when it is written, and
+ * both must match exactly. Comparing timestamps alone is not enough: on file systems with
+ * coarse timestamps a CSV saved in the same tick as the snapshot would look unchanged.
+ *
+ * Input parameters:
+ *   reader - Snapshot reader positioned at the CSV stamps
+ *
+ * Return value:
+ *   true if every CSV file is unchanged since the snapshot was written
+ */
+bool AppState::isSnapshotFresh(SnapshotReader &reader)
+{
+    for (const char *csvFile : CSV_FILES)
+    {
+        int64_t size, modified;
+        statCSVFile(csvFile, size, modified);
+        if (reader.readInt64() != size || reader.readInt64() != modified)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Writes every table and the prebuilt gameNames suffix array to a binary snapshot.
+ * Each table is stored column by column: fixed-width int columns followed by string columns.
+ * The tables are preceded by the size and modification time of each CSV file, which
+ * isSnapshotFresh() checks on the next startup.
+ *
+ * Input parameters:
+ *   filename - Path of the snapshot file to write
+ *
+ * Return value:
+ *   true if the snapshot was written successfully
+ */
+bool AppState::saveSnapshot(const std::string &filename)
+{
+    SnapshotWriter writer;
+
+    // Stamp the CSV files the tables were loaded from, so a later change to any of them
+    // makes the snapshot stale
+    for (const char *csvFile : CSV_FILES)
+    {
+        int64_t size, modified;
+        statCSVFile(csvFile, size, modified);
+        writer.writeInt64(size);
+        writer.writeInt64(modified);
+    }
+
+    // Columns are streamed straight out of the tables instead of copying every row first
+    auto memberRows = members.values();
+    writer.writeInt(members.getSize());
+    writer.writeIntColumn(memberRows, [](const Member &m)
+                          { return m.id; });
+    writer.writeIntColumn(memberRows, [](const Member &m)
+                          { return m.isAdmin ? 1 : 0; });
+    writer.writeStringColumn(memberRows, [](const Member &m)
+                             { return m.username.view(); });
+
+    auto gameRows = indexRange(0, games.getSize());
+    writer.writeInt(games.getSize());
+    writer.writeIntColumn(gameRows, [this](int row)
+                          { return games.view(row).id(); });
+    writer.writeIntColumn(gameRows, [this](int row)
+                          { return games.view(row).minPlayers(); });
+    writer.writeIntColumn(gameRows, [this](int row)
+                          { return games.view(row).maxPlayers(); });
+    writer.writeIntColumn(gameRows, [this](int row)
+                          { return games.view(row).minPlaytime(); });
+    writer.writeIntColumn(gameRows, [this](int row)
+                          { return games.view(row).maxPlaytime(); });
+    writer.writeIntColumn(gameRows, [this](int row)
+                          { return games.view(row).yearPublished(); });
+    writer.writeIntColumn(gameRows, [this](int row)
+                          { return games.view(row).isDeleted() ? 1 : 0; });
+    writer.writeStringColumn(gameRows, [this](int row)
+                             { return games.view(row).name().view(); });
+
+    auto borrowRows = borrows.values();
+    writer.writeInt(borrows.getSize());
+    writer.writeIntColumn(borrowRows, [](const Borrow &b)
+                          { return b.borrowId; });
+    writer.writeIntColumn(borrowRows, [](const Borrow &b)
+                          { return b.memberId; });
+    writer.writeIntColumn(borrowRows, [](const Borrow &b)
+                          { return b.gameId; });
+    writer.writeIntColumn(borrowRows, [](const Borrow &b)
+                          { return b.dateBorrowed; });
+    writer.writeIntColumn(borrowRows, [](const Borrow &b)
+                          { return b.dateReturned; });
+
+    auto reviewRows = reviews.values();
+    writer.writeInt(reviews.getSize());
+    writer.writeIntColumn(reviewRows, [](const Review &r)
+                          { return r.reviewId; });
+    writer.writeIntColumn(reviewRows, [](const Review &r)
+                          { return r.userId; });
+    writer.writeIntColumn(reviewRows, [](const Review &r)
+                          { return r.gameId; });
+    writer.writeIntColumn(reviewRows, [](const Review &r)
+                          { return r.rating; });
+    writer.writeStringColumn(reviewRows, [](const Review &r) -> const std::string &
+                             { return r.content; });
+
+    const Vector<SuffixEntry> &suffixes = gameNames.getSuffixes();
+    Vector<std::string> gameNamesText;
+    gameNamesText.append(gameNames.getText());
+    writer.writeStringColumn(gameNamesText, [](const std::string &text) -> const std::string &
+                             { return text; });
+    writer.writeInt(suffixes.getSize());
+    writer.writeIntColumn(suffixes, [](const SuffixEntry &e)
+                          { return e.i; });
+    writer.writeIntColumn(suffixes, [](const SuffixEntry &e)
+                          { return e.j; });
+
+    return writer.saveToFile(filename, SNAPSHOT_VERSION);
+}
+
+/*
+ * Restores all tables, secondary indexes and the gameNames suffix array from a binary snapshot.
+ * Integer fields are read directly from their columns; no CSV splitting or number parsing is done.
+ *
+ * Input parameters:
+ *   filename - Path of the snapshot file to read
+ *
+ * Return value:
+ *   true if the snapshot was valid and loaded, false if it is missing, outdated or corrupt
+ *   (in which case all tables are left empty)
+ */
+bool AppState::loadSnapshot(const std::string &filename)
+{
+    SnapshotReader reader;
+    if (!reader.open(filename, SNAPSHOT_VERSION))
+    {
+        return false;
+    }
+
+    try
+    {
+        if (!isSnapshotFresh(reader))
+        {
+            return false;
+        }
+
+        int count = reader.readInt();
+        const int32_t *ids = reader.readIntColumn(count);
+        const int32_t *isAdmin = reader.readIntColumn(count);
+        SnapshotStringColumn usernames = reader.readStringColumn(count);
+        for (int i = 0; i < count; i++)
+        {
+            Member member(ids[i], StringPool::global().intern(usernames.view(i)), isAdmin[i] != 0);
+            members.insert(member.id, member);
+            indexMember(member);
+        }
+
+        count = reader.readInt();
+        ids = reader.readIntColumn(count);
+        const int32_t *minPlayers = reader.readIntColumn(count);
+        const int32_t *maxPlayers = reader.readIntColumn(count);
+        const int32_t *minPlaytime = reader.readIntColumn(count);
+        const int32_t *maxPlaytime = reader.readIntColumn(count);
+        const int32_t *yearPublished = reader.readIntColumn(count);
+        const int32_t *isDeleted = reader.readIntColumn(count);
+        SnapshotStringColumn names = reader.readStringColumn(count);
+        for (int i = 0; i < count; i++)
+        {
+            StringHandle name = StringPool::global().intern(names.view(i));
+            games.insert(ids[i], Game(ids[i], name, minPlayers[i], maxPlayers[i],
+                                      minPlaytime[i], maxPlaytime[i], yearPublished[i], isDeleted[i] != 0));
+            indexGameName(ids[i], name);
+        }
+
+        count = reader.readInt();
+        ids = reader.readIntColumn(count);
+        const int32_t *memberIds = reader.readIntColumn(count);
+        const int32_t *gameIds = reader.readIntColumn(count);
+        const int32_t *datesBorrowed = reader.readIntColumn(count);
+        const int32_t *datesReturned = reader.readIntColumn(count);
+        for (int i = 0; i < count; i++)
+        {
+            Borrow borrow(ids[i], memberIds[i], gameIds[i], datesBorrowed[i], datesReturned[i]);
+            borrows.insert(borrow.borrowId, borrow);
+            indexBorrow(borrow);
+        }
+        rebuildBorrowLog();
+        rebuildLoanIntervals();
+        rebuildRecentBorrows();
+
+        count = reader.readInt();
+        ids = reader.readIntColumn(count);
+        const int32_t *userIds = reader.readIntColumn(count);
+        gameIds = reader.readIntColumn(count);
+        const int32_t *ratings = reader.readIntColumn(count);
+        SnapshotStringColumn contents = reader.readStringColumn(count);
+        for (int i = 0; i < count; i++)
+        {
+            Review review(ids[i], userIds[i], gameIds[i], ratings[i], contents.get(i));
+            reviews.insert(review.reviewId, review);
+            indexReview(review);
+        }
+
+        std::string text = reader.readStringColumn(1).get(0);
+        count = reader.readInt();
+        const int32_t *positions = reader.readIntColumn(count);
+        const int32_t *itemIds = reader.readIntColumn(count);
+        Vector<SuffixEntry> suffixes(count > 0 ? count : 1);
+        for (int i = 0; i < count; i++)
+        {
+            suffixes.append(SuffixEntry(positions[i], itemIds[i]));
+        }
+        gameNames = SuffixArray::fromParts(text, suffixes);
+        rebuildGamesByPlayerCount();
+        gameFilter.rebuild();
+    }
+    catch (const std::exception &)
+    {
+        clearData();
+        return false;
+    }
+
+    printf("Loaded %d members, %d games, %d borrow records and %d reviews from %s\n",
+           members.getSize(), games.getSize(), borrows.getSize(), reviews.getSize(), filename.c_str());
+    return true;
+}
+
+void AppState::clearData()
+{
+    members.clear();
+    membersByUsername.clear();
+    games.clear();
+    gamesByName.clear();
+    gamesByPlayerCount.clear();
+    gameFilter.rebuild();
+    gameNames = SuffixArray();
+    borrows.clear();
+    borrowsByMember.clear();
+    borrowsByGame.clear();
+    loanStatsByGame.clear();
+    borrowLog.clear();
+    activeBorrowsByMember.clear();
+    borrowsByDueTime.clear();
+    loanIntervalsByGame.clear();
+    borrowedGames.clear();
+    reviews.clear();
+    reviewsByGame.clear();
+    ratingsByGame.clear();
+    ratingsByTitle.clear();
+    borrowCountsByTitle.clear();
+    recentBorrows.clear();
+    topRatedGames.clear();
+    mostBorrowedGames.clear();
+    trendingGames.clear();
+}
+
 std::optional<Member> AppState::authenticateMember(const std::string &username)
 {
-    if (!membersByUsername.exists(username))
+    // Look the name up without interning it, so mistyped usernames are not stored
+    std::optional<StringHandle> handle = StringPool::global().find(username);
+    if (!handle.has_value() || !membersByUsername.exists(*handle))
     {
         return std::nullopt;
     }
 
-    int memberId = membersByUsername.get(username);
+    int memberId = membersByUsername.get(*handle);
 
     if (members.exists(memberId))
     {
@@ -136,18 +602,19 @@ std::optional<Member> AppState::authenticateMember(const std::string &username)
  */
 bool AppState::addMember(const std::string &username, bool isAdmin)
 {
-    if (membersByUsername.exists(username))
+    StringHandle handle = StringPool::global().intern(username);
+    if (membersByUsername.exists(handle))
     {
         return false;
     }
 
     int memberId = members.maxKey() + 1;
-    Member newMember(memberId, username, isAdmin);
+    Member newMember(memberId, handle, isAdmin);
 
     members.insert(memberId, newMember);
-    membersByUsername.insert(username, memberId);
+    indexMember(newMember);
 
-    saveToFile<int, Member>("members.csv", Member::csvHeader(), members, Member::toCSVRow);
+    saveToFile<int, Member>("members.csv", Member::csvHeader(), members, Member::writeCSVRow);
     return true;
 }
 
@@ -169,9 +636,44 @@ void AppState::logout()
  */
 bool AppState::addGame(const Game &game)
 {
+    // Replacing an existing game: take the old record out of the indexes first
+    int existingRow = games.findRow(game.id);
+    bool isRenamed = false;
+    StringHandle oldName;
+    if (existingRow != -1)
+    {
+        Game existing = games.get(game.id);
+        oldName = existing.name;
+        isRenamed = existing.name != game.name;
+        unindexGamePlayerCounts(existing);
+        gameFilter.removeRow(existingRow);
+        if (isRenamed)
+        {
+            unindexGameName(game.id, existing.name);
+        }
+    }
+
     games.insert(game.id, game);
+    if (existingRow == -1 || isRenamed)
+    {
+        indexGameName(game.id, game.name);
+    }
+    gameFilter.addRow(games.findRow(game.id));
     rebuildGameNames();
-    saveToFile<int, Game>("games.csv", Game::csvHeader(), games, Game::toCSVRow);
+    if (!game.isDeleted)
+    {
+        indexGamePlayerCounts(game);
+    }
+    if (isRenamed)
+    {
+        // The copy's reviews and borrows now count towards its new title
+        rebuildTitleAggregates(oldName);
+        rebuildTitleAggregates(game.name);
+        rebuildRecentBorrows();
+        refreshLeaderboards(oldName);
+    }
+    refreshLeaderboards(game.name);
+    saveToFile<int, Game>("games.csv", Game::csvHeader(), games, Game::writeCSVRow);
     return true;
 }
 
@@ -202,54 +704,197 @@ bool AppState::removeGame(int gameId)
     }
 
     Game game = games.get(gameId);
-    game.isDeleted = true;
-    games.insert(gameId, game);
+    unindexGamePlayerCounts(game);
+    gameFilter.removeRow(games.findRow(gameId));
+    games.markDeleted(gameId);
     rebuildGameNames();
-    saveToFile<int, Game>("games.csv", Game::csvHeader(), games, Game::toCSVRow);
+    refreshLeaderboards(game.name);
+    saveToFile<int, Game>("games.csv", Game::csvHeader(), games, Game::writeCSVRow);
     return true;
 }
 
-Vector<Game> AppState::getGamesForPlayerCount(int playerCount)
+/*
+ * Retrieves the ids of all non-deleted games that support a player count, sorted by name.
+ * Counts up to MAX_INDEXED_PLAYER_COUNT are answered from the gamesByPlayerCount index;
+ * larger counts fall back to a column scan of the game table.
+ *
+ * Input parameters:
+ *   playerCount - The number of players
+ *
+ * Return value:
+ *   A vector of game ids sorted alphabetically by game name
+ */
+Vector<int> AppState::getGameIdsForPlayerCount(int playerCount)
+{
+    if (playerCount <= 0)
+    {
+        return Vector<int>();
+    }
+
+    if (playerCount < gamesByPlayerCount.getSize())
+    {
+        return gamesByPlayerCount[playerCount];
+    }
+
+    Vector<int> rows = games.findRowsForPlayerCount(playerCount);
+    Sort::quicksort(rows, [&](const int &a, const int &b)
+                    { return games.compareNames(a, b); });
+
+    Vector<int> matchingIds;
+    for (int i = 0; i < rows.getSize(); i++)
+    {
+        matchingIds.append(games.view(rows[i]).id());
+    }
+    return matchingIds;
+}
+
+/*
+ * Finds the non-deleted games matching every criterion of a query using the bitmap indexes.
+ * The matches are only sorted as far as they are read, since most users only look at page 1.
+ * Parameters: query - the criteria to apply (0 fields are ignored)
+ * Returns: the game table rows of the matching games, in name order
+ */
+LazySortedView<int, GameRowOrder> AppState::filterGames(const GameQuery &query)
 {
-    Vector<Game> matchingGames;
-    games.forEach([&](const int &id, const Game &game)
-                  {
-        if (!game.isDeleted && playerCount >= game.minPlayers && playerCount <= game.maxPlayers)
+    return LazySortedView<int, GameRowOrder>(gameFilter.query(query).toVector(), GameRowOrder(&games));
+}
+
+/*
+ * Rebuilds the player count index from the game table.
+ * All active games are sorted by name once and then appended, in that order, to the list
+ * of every player count they support, so each list comes out already sorted.
+ */
+void AppState::rebuildGamesByPlayerCount()
+{
+    gamesByPlayerCount.clear();
+    for (int count = 0; count <= MAX_INDEXED_PLAYER_COUNT; count++)
+    {
+        gamesByPlayerCount.append(Vector<int>(4));
+    }
+
+    Vector<int> rows;
+    for (int row = 0; row < games.getSize(); row++)
+    {
+        if (!games.view(row).isDeleted())
         {
-            matchingGames.append(game);
-        } });
+            rows.append(row);
+        }
+    }
+    Sort::quicksort(rows, GameRowOrder(&games));
 
-    Sort::quicksort(
-        matchingGames,
-        [](const Game &a, const Game &b)
-        { return a.name < b.name ? -1 : (a.name > b.name ? 1 : 0); });
+    for (int i = 0; i < rows.getSize(); i++)
+    {
+        GameView game = games.view(rows[i]);
+        int maxCount = game.maxPlayers() < MAX_INDEXED_PLAYER_COUNT ? game.maxPlayers() : MAX_INDEXED_PLAYER_COUNT;
+        for (int count = game.minPlayers() > 1 ? game.minPlayers() : 1; count <= maxCount; count++)
+        {
+            gamesByPlayerCount[count].append(game.id());
+        }
+    }
+}
 
-    return matchingGames;
+/*
+ * Finds where a game id belongs in a name-sorted player count list.
+ * Games are ordered by name, with rows (insertion order) breaking ties between copies.
+ */
+static int findPlayerCountSlot(const GameTable &games, const Vector<int> &ids, int gameRow)
+{
+    return binarySearch(
+        ids.getSize(),
+        [&](int mid)
+        {
+            int midRow = games.findRow(ids[mid]);
+            int nameCompare = games.compareNames(midRow, gameRow);
+            int order = nameCompare != 0 ? nameCompare : midRow - gameRow;
+            return order < 0 ? -1 : (order > 0 ? 1 : 0);
+        },
+        false);
+}
+
+void AppState::indexGamePlayerCounts(const Game &game)
+{
+    int row = games.findRow(game.id);
+    int maxCount = game.maxPlayers < MAX_INDEXED_PLAYER_COUNT ? game.maxPlayers : MAX_INDEXED_PLAYER_COUNT;
+    for (int count = game.minPlayers > 1 ? game.minPlayers : 1; count <= maxCount; count++)
+    {
+        Vector<int> &ids = gamesByPlayerCount[count];
+        ids.insert(findPlayerCountSlot(games, ids, row), game.id);
+    }
+}
+
+void AppState::unindexGamePlayerCounts(const Game &game)
+{
+    int row = games.findRow(game.id);
+    int maxCount = game.maxPlayers < MAX_INDEXED_PLAYER_COUNT ? game.maxPlayers : MAX_INDEXED_PLAYER_COUNT;
+    for (int count = game.minPlayers > 1 ? game.minPlayers : 1; count <= maxCount; count++)
+    {
+        Vector<int> &ids = gamesByPlayerCount[count];
+        int slot = findPlayerCountSlot(games, ids, row);
+        if (slot < ids.getSize() && ids[slot] == game.id)
+        {
+            ids.remove(slot);
+        }
+    }
 }
 
 Vector<Game> AppState::searchGames(const std::string &query, std::function<bool(const Game &)> filter)
 {
-    Vector<int> ids = gameNames.search(query);
-    Vector<Game> result;
-    for (int i = 0; i < ids.getSize(); i++)
+    if (filter == nullptr)
     {
-        Game game = games.get(ids[i]);
-        if (filter == nullptr || filter(game))
+        return searchGames(query, [](const Game &)
+                           { return true; });
+    }
+    return searchGames<std::function<bool(const Game &)>>(query, filter);
+}
+
+/*
+ * Finds a non-deleted copy of a game by its exact name.
+ * Parameters: name - the game name
+ * Returns: the first active copy, or std::nullopt if every copy is deleted or none exists
+ */
+std::optional<Game> AppState::findActiveGameByName(StringHandle name)
+{
+    const Vector<int> *gameIds = gamesByName.find(name);
+    if (gameIds == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    for (int i = 0; i < gameIds->getSize(); i++)
+    {
+        int row = games.findRow((*gameIds)[i]);
+        if (row != -1 && !games.view(row).isDeleted())
         {
-            result.append(game);
+            return games.view(row).toGame();
         }
     }
+    return std::nullopt;
+}
 
-    return result;
+/*
+ * Finds a non-deleted copy of a game by a name typed by the user. The name is looked up
+ * without being interned, since no game can have a name the pool has never seen.
+ * Parameters: name - the game name
+ * Returns: the first active copy, or std::nullopt if every copy is deleted or none exists
+ */
+std::optional<Game> AppState::findActiveGameByName(const std::string &name)
+{
+    std::optional<StringHandle> handle = StringPool::global().find(name);
+    if (!handle.has_value())
+    {
+        return std::nullopt;
+    }
+    return findActiveGameByName(*handle);
 }
 
-std::string AppState::getGameNameById(int gameId)
+StringHandle AppState::getGameNameById(int gameId)
 {
-    if (games.exists(gameId))
+    int row = games.findRow(gameId);
+    if (row != -1)
     {
-        return games.get(gameId).name;
+        return games.view(row).name();
     }
-    return "Unknown Game";
+    return StringPool::global().intern("Unknown Game");
 }
 
 bool AppState::borrowGame(int gameId)
@@ -260,19 +905,15 @@ bool AppState::borrowGame(int gameId)
     if (borrowedGames.exists(gameId))
         return false;
 
-    Borrow newBorrow(borrows.maxKey() + 1, currentUserId, gameId, getCurrentDateTime());
+    Borrow newBorrow(borrows.maxKey() + 1, currentUserId, gameId, DateHelper::getCurrentTimestamp());
 
     borrows.insert(newBorrow.borrowId, newBorrow);
-    Vector<int> borrowIds;
-    if (borrowsByMember.exists(currentUserId))
-    {
-        borrowIds = borrowsByMember.get(currentUserId);
-    }
-    borrowIds.append(newBorrow.borrowId);
-    borrowsByMember.insert(currentUserId, borrowIds);
-    borrowedGames.insert(gameId);
+    borrowLog.add(newBorrow.dateBorrowed, newBorrow.borrowId);
+    recentBorrows.record(getGameNameById(gameId), newBorrow.dateBorrowed);
+    indexBorrow(newBorrow);
+    loanIntervalsByGame.findOrInsert(gameId).add(newBorrow.dateBorrowed, newBorrow.dateReturned, newBorrow.borrowId);
 
-    saveToFile<int, Borrow>("borrows.csv", Borrow::csvHeader(), borrows, Borrow::toCSVRow);
+    saveToFile<int, Borrow>("borrows.csv", Borrow::csvHeader(), borrows, Borrow::writeCSVRow);
     return true;
 }
 
@@ -285,38 +926,78 @@ bool AppState::returnGame(int borrowId)
         return false;
 
     Borrow borrow = borrows.get(borrowId);
-    if (borrow.memberId != currentUserId)
+    if (borrow.memberId != currentUserId || borrow.isReturned())
         return false;
 
-    borrow.dateReturned = getCurrentDateTime();
+    borrow.dateReturned = DateHelper::getCurrentTimestamp();
     borrows.insert(borrowId, borrow);
     borrowedGames.remove(borrow.gameId);
 
-    saveToFile<int, Borrow>("borrows.csv", Borrow::csvHeader(), borrows, Borrow::toCSVRow);
+    activeBorrowsByMember.findOrInsert(borrow.memberId).remove(borrow.dateBorrowed, borrowId);
+    borrowsByDueTime.remove(borrowId);
+    loanIntervalsByGame.findOrInsert(borrow.gameId).setEnd(borrow.dateBorrowed, borrowId, borrow.dateReturned);
+    loanStatsByGame.findOrInsert(borrow.gameId).recordReturn(borrow);
+
+    saveToFile<int, Borrow>("borrows.csv", Borrow::csvHeader(), borrows, Borrow::writeCSVRow);
     return true;
 }
 
 /*
- * Retrieves a summary of all games borrowed and returned in the system.
- * Copies the values of the borrows dictionary into a vector and sorts them
- * by datetime borrowed (primary) and datetime returned (secondary).
- *
- * Input parameters:
- *   None
- *
- * Return value:
- *   A vector of Borrow objects sorted by borrow and return dates
+ * Rebuilds the chronological borrow log from the borrow records, sorting them once by
+ * (borrow time, borrow id). After this, borrowGame() keeps the log ordered by appending.
  */
-Vector<Borrow> AppState::getAllBorrows()
+void AppState::rebuildBorrowLog()
 {
-    Vector<Borrow> sortedBorrows = borrows.toVector();
-    Sort::quicksort(sortedBorrows, [](const Borrow &b1, const Borrow &b2)
-                    {
-        int borrowCompare = compareDates(b2.dateBorrowed, b1.dateBorrowed);
-        if (borrowCompare != 0)
-            return borrowCompare;
-        return compareDates(b2.dateReturned, b1.dateReturned); });
-    return sortedBorrows;
+    Vector<TimeIndexEntry<int>> records(borrows.getSize() > 0 ? borrows.getSize() : 1);
+    borrows.forEach([&](const int &borrowId, const Borrow &borrow)
+                    { records.append(TimeIndexEntry<int>(borrow.dateBorrowed, borrowId)); });
+    borrowLog.build(records);
+}
+
+/*
+ * Rebuilds the per-game loan intervals by walking the borrow log oldest first, so each
+ * game's intervals arrive in start order and are appended instead of shifted into place.
+ * Call after rebuildBorrowLog().
+ */
+void AppState::rebuildLoanIntervals()
+{
+    loanIntervalsByGame.clear();
+    for (int position = 0; position < borrowLog.getSize(); position++)
+    {
+        const Borrow &borrow = *borrows.find(borrowLog.at(position).key);
+        loanIntervalsByGame.findOrInsert(borrow.gameId).add(borrow.dateBorrowed, borrow.dateReturned, borrow.borrowId);
+    }
+}
+
+int AppState::getBorrowLogSize()
+{
+    return borrowLog.getSize();
+}
+
+/*
+ * Retrieves a borrow record by its position in the chronological log.
+ * Parameters: position - 0 for the oldest borrow, getBorrowLogSize() - 1 for the newest
+ * Returns: a copy of the borrow record
+ */
+Borrow AppState::getBorrowLogEntry(int position)
+{
+    return borrows.get(borrowLog.at(position).key);
+}
+
+/*
+ * Finds the span of the borrow log borrowed within a date range, by binary search.
+ * Parameters: from, to - inclusive bounds on the borrow time
+ *             start, end - receive the log positions [start, end) of the matching borrows
+ * Returns: nothing
+ */
+void AppState::findBorrowLogRange(DateHelper::Timestamp from, DateHelper::Timestamp to, int &start, int &end)
+{
+    start = borrowLog.lowerBound(from);
+    end = to == INT32_MAX ? borrowLog.getSize() : borrowLog.lowerBound(to + 1);
+    if (end < start)
+    {
+        end = start;
+    }
 }
 
 Vector<Borrow> AppState::getMemberBorrows()
@@ -325,25 +1006,138 @@ Vector<Borrow> AppState::getMemberBorrows()
         return Vector<Borrow>();
 
     Vector<Borrow> memberBorrows;
-    if (!borrowsByMember.exists(currentUserId))
+    const Vector<int> *borrowIds = borrowsByMember.find(currentUserId);
+    if (borrowIds == nullptr)
         return memberBorrows;
 
-    Vector<int> borrowIds = borrowsByMember.get(currentUserId);
-    for (int i = 0; i < borrowIds.getSize(); i++)
+    for (int i = 0; i < borrowIds->getSize(); i++)
     {
-        int borrowId = borrowIds.get(i);
+        int borrowId = borrowIds->get(i);
         memberBorrows.append(borrows.get(borrowId));
     }
 
-    Sort::quicksort(memberBorrows, [](const Borrow &b1, const Borrow &b2)
-                    {
-        int borrowCompare = compareDates(b2.dateBorrowed, b1.dateBorrowed);
-        if (borrowCompare != 0)
-            return borrowCompare;
-        return compareDates(b2.dateReturned, b1.dateReturned); });
+    // Borrow ids are appended in borrow order, so this is mostly one descending run;
+    // stable so ties keep the same order between page visits
+    Sort::stableSort(memberBorrows,
+                     Sort::thenBy(Sort::descending(Sort::by([](const Borrow &b)
+                                                            { return b.dateBorrowed; })),
+                                  Sort::descending(Sort::by([](const Borrow &b)
+                                                            { return b.dateReturned; }))));
     return memberBorrows;
 }
 
+/*
+ * Retrieves the current member's unreturned borrows from the active-loan index,
+ * without reading the member's borrow history.
+ *
+ * Return value:
+ *   A vector of the member's active Borrow records, most recently borrowed first
+ */
+Vector<Borrow> AppState::getActiveMemberBorrows()
+{
+    Vector<Borrow> activeBorrows;
+    const TimeIndex<int> *borrowIds = activeBorrowsByMember.find(currentUserId);
+    if (borrowIds == nullptr)
+        return activeBorrows;
+
+    for (int i = 0; i < borrowIds->getSize(); i++)
+    {
+        activeBorrows.append(borrows.get(borrowIds->newest(i).key));
+    }
+    return activeBorrows;
+}
+
+/*
+ * Returns when a borrow is due back: LOAN_PERIOD_DAYS after it was borrowed.
+ */
+DateHelper::Timestamp AppState::getDueTime(const Borrow &borrow)
+{
+    return borrow.dateBorrowed + LOAN_PERIOD_DAYS * DateHelper::MINUTES_PER_DAY;
+}
+
+/*
+ * Retrieves every unreturned borrow whose due time has passed.
+ * Only active loans are kept in the due-time heap, and only the overdue ones
+ * are visited, so this is O(k log k) for k overdue loans.
+ *
+ * Input parameters:
+ *   now - The current time
+ *
+ * Return value:
+ *   A vector of overdue Borrow records, most overdue first
+ */
+Vector<Borrow> AppState::getOverdueBorrows(DateHelper::Timestamp now)
+{
+    Vector<Borrow> overdueBorrows;
+    borrowsByDueTime.forEachAtMost(now - 1, [&](const int &borrowId, int)
+                                   { overdueBorrows.append(borrows.get(borrowId)); });
+
+    Sort::radixSortBy(overdueBorrows, borrowTimeOrder);
+    return overdueBorrows;
+}
+
+/*
+ * Retrieves the loans of one game copy that overlap a time range, i.e. who held it then.
+ * Binary-searches the game's loan intervals instead of scanning every borrow.
+ *
+ * Input parameters:
+ *   gameId - The game copy to look up
+ *   from, to - The half-open time range [from, to); use to = from + 1 for a point in time
+ *
+ * Return value:
+ *   A vector of the overlapping Borrow records, oldest first
+ */
+Vector<Borrow> AppState::getGameLoansBetween(int gameId, DateHelper::Timestamp from, DateHelper::Timestamp to)
+{
+    Vector<Borrow> loans;
+    const IntervalList<int> *loanIntervals = loanIntervalsByGame.find(gameId);
+    if (loanIntervals == nullptr)
+        return loans;
+
+    int first, last;
+    loanIntervals->findOverlapping(from, to, first, last);
+    for (int i = first; i < last; i++)
+    {
+        loans.append(borrows.get(loanIntervals->at(i).key));
+    }
+    return loans;
+}
+
+/*
+ * Calculates the share of a time range during which a game copy was on loan.
+ *
+ * Input parameters:
+ *   gameId - The game copy to look up
+ *   from, to - The half-open time range [from, to)
+ *
+ * Return value:
+ *   The utilisation as a percentage from 0 to 100 (0 for an empty range)
+ */
+float AppState::getGameUtilisation(int gameId, DateHelper::Timestamp from, DateHelper::Timestamp to)
+{
+    const IntervalList<int> *loanIntervals = loanIntervalsByGame.find(gameId);
+    if (to <= from || loanIntervals == nullptr)
+        return 0.0f;
+
+    long long covered = loanIntervals->coveredLength(from, to);
+    return (float)(covered * 100.0 / ((long long)to - from));
+}
+
+/*
+ * Retrieves the running loan statistics of one game copy.
+ *
+ * Input parameters:
+ *   gameId - The game copy to look up
+ *
+ * Return value:
+ *   The game's LoanStats (all zero if it has never been borrowed)
+ */
+LoanStats AppState::getGameLoanStats(int gameId)
+{
+    const LoanStats *stats = loanStatsByGame.find(gameId);
+    return stats == nullptr ? LoanStats() : *stats;
+}
+
 bool AppState::isGameBorrowed(int gameId)
 {
     return borrowedGames.exists(gameId);
@@ -371,28 +1165,22 @@ bool AppState::addReview(int gameId, int rating, const std::string &content)
     Review newReview(reviews.maxKey() + 1, currentUserId, gameId, rating, content);
 
     reviews.insert(newReview.reviewId, newReview);
-    Vector<int> reviewIds;
-    if (reviewsByGame.exists(gameId))
-    {
-        reviewIds = reviewsByGame.get(gameId);
-    }
-    reviewIds.append(newReview.reviewId);
-    reviewsByGame.insert(gameId, reviewIds);
+    indexReview(newReview);
 
-    saveToFile<int, Review>("reviews.csv", Review::csvHeader(), reviews, Review::toCSVRow);
+    saveToFile<int, Review>("reviews.csv", Review::csvHeader(), reviews, Review::writeCSVRow);
     return true;
 }
 
 Vector<Review> AppState::getReviewsForGame(int gameId)
 {
     Vector<Review> gameReviews;
-    if (!reviewsByGame.exists(gameId))
+    const Vector<int> *reviewIds = reviewsByGame.find(gameId);
+    if (reviewIds == nullptr)
         return gameReviews;
 
-    Vector<int> reviewIds = reviewsByGame.get(gameId);
-    for (int i = 0; i < reviewIds.getSize(); i++)
+    for (int i = 0; i < reviewIds->getSize(); i++)
     {
-        int reviewId = reviewIds.get(i);
+        int reviewId = reviewIds->get(i);
         gameReviews.append(reviews.get(reviewId));
     }
     return gameReviews;
@@ -412,35 +1200,24 @@ Vector<Review> AppState::getReviewsForGame(int gameId)
  *   A vector of Review objects for all game instances with the given name,
  *   or an empty vector if no active game with that name exists
  */
-Vector<Review> AppState::getReviewsForGameName(const std::string &gameName)
+Vector<Review> AppState::getReviewsForGameName(StringHandle gameName)
 {
     Vector<Review> allReviews;
-    Vector<Game> allGames = games.toVector();
-
-    // First check if at least one non-deleted game with this name exists
-    bool hasActiveGame = false;
-    for (int i = 0; i < allGames.getSize(); i++)
+    if (!findActiveGameByName(gameName).has_value())
     {
-        if (allGames.get(i).name == gameName && !allGames.get(i).isDeleted)
-        {
-            hasActiveGame = true;
-            break;
-        }
+        return allReviews;
     }
 
-    // If at least one copy exists, get reviews from ALL games with this name (including deleted ones)
-    if (hasActiveGame)
+    // At least one copy exists, so get reviews from ALL games with this name (including deleted ones)
+    const Vector<int> *gameIds = gamesByName.find(gameName);
+    for (int gameId : *gameIds)
     {
-        for (int i = 0; i < allGames.getSize(); i++)
+        const Vector<int> *reviewIds = reviewsByGame.find(gameId);
+        if (reviewIds == nullptr)
+            continue;
+        for (int reviewId : *reviewIds)
         {
-            if (allGames.get(i).name == gameName)
-            {
-                Vector<Review> gameReviews = getReviewsForGame(allGames.get(i).id);
-                for (int j = 0; j < gameReviews.getSize(); j++)
-                {
-                    allReviews.append(gameReviews.get(j));
-                }
-            }
+            allReviews.append(*reviews.find(reviewId));
         }
     }
 
@@ -448,51 +1225,136 @@ Vector<Review> AppState::getReviewsForGameName(const std::string &gameName)
 }
 
 /*
- * Calculates the average rating for a game by its name.
- * Uses getReviewsForGameName() to aggregate reviews across all instances
- * of a game with the same name, then computes the average rating.
+ * Returns the average rating for a game by its name, across every copy of the game.
+ * Reads the running aggregate kept by indexReview(), so no reviews are visited.
  *
  * Input parameters:
  *   gameName - The name of the game to calculate average rating for
  *
  * Return value:
- *   The average rating as a float (0.0 if no reviews exist)
+ *   The average rating as a float (0.0 if no reviews exist or no copy is active)
  */
-float AppState::getAverageRatingByGameName(const std::string &gameName)
+float AppState::getAverageRatingByGameName(StringHandle gameName)
 {
-    Vector<Review> gameReviews = getReviewsForGameName(gameName);
-    if (gameReviews.isEmpty())
-        return 0.0f;
+    return getRatingStatsByGameName(gameName).average();
+}
 
-    int totalRating = 0;
-    for (int i = 0; i < gameReviews.getSize(); i++)
+/*
+ * Returns the rating aggregate (count, sum, distribution) for a game by its name.
+ * Parameters: gameName - the name of the game
+ * Returns: the aggregate across every copy, or an empty one if no copy is active
+ */
+RatingStats AppState::getRatingStatsByGameName(StringHandle gameName)
+{
+    const RatingStats *stats = ratingsByTitle.find(gameName);
+    if (stats == nullptr || !findActiveGameByName(gameName).has_value())
     {
-        totalRating += gameReviews.get(i).rating;
+        return RatingStats();
     }
-
-    return (float)totalRating / gameReviews.getSize();
+    return *stats;
 }
 
 std::string AppState::getMemberNameById(int memberId)
 {
-    if (members.exists(memberId))
+    const Member *member = members.find(memberId);
+    if (member != nullptr)
     {
-        return members.get(memberId).username;
+        return member->username.str();
     }
     return "Unknown Member";
 }
 
-Vector<Game> AppState::getGames()
+void AppState::rebuildGameNames()
 {
-    return games.toVector();
+    gameNames = SuffixArray::build(
+        indexRange(0, games.getSize()),
+        [this](int row)
+        { return games.view(row).name().str(); },
+        [this](int row)
+        { return games.view(row).id(); });
 }
 
-void AppState::rebuildGameNames()
+/*
+ * Re-scores one title on every leaderboard from its current aggregates.
+ * Titles without an active copy are taken off the leaderboards until a copy is added again.
+ * Parameters: title - the game title
+ * Returns: nothing
+ */
+void AppState::refreshLeaderboards(StringHandle title)
 {
-    gameNames = SuffixArray::build<Game>(
-        games.toVector(),
-        [](const Game &game)
-        { return game.name; },
-        [](const Game &game)
-        { return game.id; });
-}
\ No newline at end of file
+    if (!findActiveGameByName(title).has_value())
+    {
+        topRatedGames.remove(title);
+        mostBorrowedGames.remove(title);
+        trendingGames.remove(title);
+        return;
+    }
+
+    const RatingStats *stats = ratingsByTitle.find(title);
+    if (stats != nullptr)
+    {
+        topRatedGames.set(title, (RATING_PRIOR_MEAN * RATING_PRIOR_WEIGHT + stats->sum) /
+                                     (RATING_PRIOR_WEIGHT + stats->count));
+    }
+    const int *borrowCount = borrowCountsByTitle.find(title);
+    if (borrowCount != nullptr)
+    {
+        mostBorrowedGames.set(title, *borrowCount);
+    }
+    int recentCount = recentBorrows.countOf(title);
+    if (recentCount > 0)
+    {
+        trendingGames.set(title, recentCount);
+    }
+    else
+    {
+        trendingGames.remove(title);
+    }
+}
+
+/*
+ * Refills the trending window from the borrow records.
+ * Borrows inside the window are replayed oldest first, since the window expires events in order.
+ */
+void AppState::rebuildRecentBorrows()
+{
+    recentBorrows.clear();
+    trendingGames.clear();
+
+    DateHelper::Timestamp windowStart = DateHelper::getCurrentTimestamp() - recentBorrows.getWindowLength();
+    Vector<Borrow> recent;
+    borrows.forEach([&](const int &, const Borrow &borrow)
+                    {
+        if (borrow.dateBorrowed > windowStart)
+        {
+            recent.append(borrow);
+        } });
+    Sort::radixSortBy(recent, borrowTimeOrder);
+
+    for (int i = 0; i < recent.getSize(); i++)
+    {
+        StringHandle title = getGameNameById(recent[i].gameId);
+        recentBorrows.record(title, recent[i].dateBorrowed);
+        refreshLeaderboards(title);
+    }
+}
+
+const Leaderboard &AppState::getTopRatedGames()
+{
+    return topRatedGames;
+}
+
+const Leaderboard &AppState::getMostBorrowedGames()
+{
+    return mostBorrowedGames;
+}
+
+/*
+ * Returns the trending leaderboard after expiring borrows that have left the window.
+ */
+const Leaderboard &AppState::getTrendingGames()
+{
+    recentBorrows.expire(DateHelper::getCurrentTimestamp(), [&](StringHandle title, int)
+                         { refreshLeaderboards(title); });
+    return trendingGames;
+}
@@ -8,34 +8,73 @@
 #include "lib/Dictionary.h"
 #include "lib/Set.h"
 #include "lib/SuffixArray.h"
+#include "lib/TimeIndex.h"
+#include "lib/IndexedMinHeap.h"
+#include "lib/IntervalList.h"
+#include "lib/LazySortedView.h"
 #include "models/Member.h"
 #include "models/Game.h"
+#include "models/GameTable.h"
+#include "models/GameFilter.h"
 #include "models/Borrow.h"
 #include "models/Review.h"
+#include "models/RatingStats.h"
+#include "models/LoanStats.h"
+#include "models/Leaderboard.h"
+
+class SnapshotReader;
 
 /// Application state coordinator - manages all data and business logic
 class AppState
 {
 public:
     int currentUserId;
-    Dictionary<int, Member> members;
-    Dictionary<std::string, int> membersByUsername;
-    Dictionary<int, Game> games;
-    Dictionary<std::string, int> gamesByName;
+    // Keyed tables are only ever added to after loading (removed games are flagged, not erased),
+    // so their nodes come from an arena; borrowedGames shrinks, so it keeps the default pool
+    Dictionary<int, Member, ArenaAllocator> members;
+    Dictionary<StringHandle, int, ArenaAllocator> membersByUsername;
+    GameTable games;
+    GameFilter gameFilter;
+    Dictionary<StringHandle, Vector<int>, ArenaAllocator> gamesByName;
     SuffixArray gameNames;
-    Dictionary<int, Borrow> borrows;
-    Dictionary<int, Vector<int>> borrowsByMember;
+    Vector<Vector<int>> gamesByPlayerCount;
+    Dictionary<int, Borrow, ArenaAllocator> borrows;
+    Dictionary<int, Vector<int>, ArenaAllocator> borrowsByMember;
+    Dictionary<int, Vector<int>, ArenaAllocator> borrowsByGame;
+    Dictionary<int, LoanStats, ArenaAllocator> loanStatsByGame;
+    TimeIndex<int> borrowLog;
+    Dictionary<int, TimeIndex<int>, ArenaAllocator> activeBorrowsByMember;
+    IndexedMinHeap<int> borrowsByDueTime;
+    Dictionary<int, IntervalList<int>, ArenaAllocator> loanIntervalsByGame;
     Set<int> borrowedGames;
-    Dictionary<int, Review> reviews;
-    Dictionary<int, Vector<int>> reviewsByGame;
+    Dictionary<int, Review, ArenaAllocator> reviews;
+    Dictionary<int, Vector<int>, ArenaAllocator> reviewsByGame;
+    Dictionary<int, RatingStats, ArenaAllocator> ratingsByGame;
+    Dictionary<StringHandle, RatingStats, ArenaAllocator> ratingsByTitle;
+    Dictionary<StringHandle, int, ArenaAllocator> borrowCountsByTitle;
+    SlidingWindowCounter recentBorrows;
+    Leaderboard topRatedGames;
+    Leaderboard mostBorrowedGames;
+    Leaderboard trendingGames;
 
     AppState();
 
     void loadData();
+    void recoverInterruptedSaves();
     void loadMembers(const std::string &filename);
     void loadGames(const std::string &filename);
     void loadBorrows(const std::string &filename);
     void loadReviews(const std::string &filename);
+    void indexMember(const Member &member);
+    void indexBorrow(const Borrow &borrow);
+    void indexReview(const Review &review);
+    void indexGameName(int gameId, StringHandle name);
+    void unindexGameName(int gameId, StringHandle name);
+    void rebuildTitleAggregates(StringHandle title);
+    bool isSnapshotFresh(SnapshotReader &reader);
+    bool saveSnapshot(const std::string &filename);
+    bool loadSnapshot(const std::string &filename);
+    void clearData();
 
     std::optional<Member> authenticateMember(const std::string &username);
     bool addMember(const std::string &username, bool isAdmin);
@@ -43,24 +82,70 @@ public:
 
     bool addGame(const Game &game);
     bool removeGame(int gameId);
-    Vector<Game> getGamesForPlayerCount(int playerCount);
+    Vector<int> getGameIdsForPlayerCount(int playerCount);
+    void rebuildGamesByPlayerCount();
+    void indexGamePlayerCounts(const Game &game);
+    void unindexGamePlayerCounts(const Game &game);
+    LazySortedView<int, GameRowOrder> filterGames(const GameQuery &query);
     Vector<Game> searchGames(const std::string &query, std::function<bool(const Game &)> filter = nullptr);
-    std::string getGameNameById(int gameId);
+    template <typename Filter>
+    Vector<Game> searchGames(const std::string &query, Filter filter);
+    StringHandle getGameNameById(int gameId);
+    std::optional<Game> findActiveGameByName(StringHandle name);
+    std::optional<Game> findActiveGameByName(const std::string &name);
     void rebuildGameNames();
 
     bool borrowGame(int gameId);
     bool returnGame(int borrowId);
-    Vector<Borrow> getAllBorrows();
+    void rebuildBorrowLog();
+    void rebuildLoanIntervals();
+    int getBorrowLogSize();
+    Borrow getBorrowLogEntry(int position);
+    void findBorrowLogRange(DateHelper::Timestamp from, DateHelper::Timestamp to, int &start, int &end);
     Vector<Borrow> getMemberBorrows();
+    Vector<Borrow> getActiveMemberBorrows();
+    DateHelper::Timestamp getDueTime(const Borrow &borrow);
+    Vector<Borrow> getOverdueBorrows(DateHelper::Timestamp now);
+    Vector<Borrow> getGameLoansBetween(int gameId, DateHelper::Timestamp from, DateHelper::Timestamp to);
+    float getGameUtilisation(int gameId, DateHelper::Timestamp from, DateHelper::Timestamp to);
+    LoanStats getGameLoanStats(int gameId);
     bool isGameBorrowed(int gameId);
 
     bool addReview(int gameId, int rating, const std::string &content);
     Vector<Review> getReviewsForGame(int gameId);
-    Vector<Review> getReviewsForGameName(const std::string &gameName);
-    float getAverageRatingByGameName(const std::string &gameName);
+    Vector<Review> getReviewsForGameName(StringHandle gameName);
+    float getAverageRatingByGameName(StringHandle gameName);
+    RatingStats getRatingStatsByGameName(StringHandle gameName);
+
+    void refreshLeaderboards(StringHandle title);
+    void rebuildRecentBorrows();
+    const Leaderboard &getTopRatedGames();
+    const Leaderboard &getMostBorrowedGames();
+    const Leaderboard &getTrendingGames();
 
     std::string getMemberNameById(int memberId);
-    Vector<Game> getGames();
 };
 
+/*
+ * Searches game names for a substring, keeping only the games a filter accepts.
+ * Takes any callable, so the filter is inlined into the loop.
+ * Parameters: query - the text to search for, filter - a function returning true for games to keep
+ * Returns: the matching games, in search order
+ */
+template <typename Filter>
+Vector<Game> AppState::searchGames(const std::string &query, Filter filter)
+{
+    Vector<int> ids = gameNames.search(query);
+    Vector<Game> result;
+    for (int i = 0; i < ids.getSize(); i++)
+    {
+        Game game = games.get(ids[i]);
+        if (filter(game))
+        {
+            result.append(game);
+        }
+    }
+    return result;
+}
+
 #endif
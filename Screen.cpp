@@ -3,6 +3,7 @@
 #include "utils/StringHelper.h"
 #include "utils/UIHelper.h"
 #include "utils/PaginationHelper.h"
+#include "utils/Date.h"
 #include "lib/Sort.h"
 #include <cstdio>
 #include <cstring>
@@ -16,7 +17,7 @@ void Screen::startup()
     printf("  NPTTGC Board Game Club System\n");
     printf("====================================\n\n");
 
-    printf("Loading data from CSV files...\n");
+    printf("Loading data...\n");
     appState.loadData();
     printf("\nData loaded successfully!\n");
 
@@ -75,7 +76,11 @@ void Screen::adminMenu()
         printf("4. Display borrow summary\n");
         printf("5. Display games by player count\n");
         printf("6. View game reviews\n");
-        printf("7. Logout\n");
+        printf("7. Filter games\n");
+        printf("8. View leaderboards\n");
+        printf("9. Display overdue loans\n");
+        printf("10. Game loan history\n");
+        printf("11. Logout\n");
         printf("================================\n");
         printf("Enter your choice: ");
 
@@ -107,6 +112,18 @@ void Screen::adminMenu()
             viewReviews();
             break;
         case 7:
+            filterGames();
+            break;
+        case 8:
+            leaderboards();
+            break;
+        case 9:
+            overdueReport();
+            break;
+        case 10:
+            gameLoanHistory();
+            break;
+        case 11:
             printf("\nLogging out...\n");
             loggedIn = false;
             break;
@@ -128,7 +145,8 @@ void Screen::memberMenu()
         printf("4. Write a review\n");
         printf("5. View game reviews\n");
         printf("6. Display games by player count\n");
-        printf("7. Logout\n");
+        printf("7. Filter games\n");
+        printf("8. Logout\n");
         printf("=================================\n");
         printf("Enter your choice: ");
 
@@ -160,6 +178,9 @@ void Screen::memberMenu()
             gamesByPlayerCount();
             break;
         case 7:
+            filterGames();
+            break;
+        case 8:
             printf("\nLogging out...\n");
             loggedIn = false;
             break;
@@ -183,22 +204,13 @@ void Screen::addGame()
     }
 
     // Check if game with this name already exists (non-deleted)
-    int existingGameIndex = -1;
-    Vector<Game> allGames = appState.getGames();
-    for (int i = 0; i < allGames.getSize(); i++)
-    {
-        if (allGames.get(i).name == gameName && !allGames.get(i).isDeleted)
-        {
-            existingGameIndex = i;
-            break;
-        }
-    }
+    std::optional<Game> existing = appState.findActiveGameByName(gameName);
 
     int minPlayers, maxPlayers, minPlaytime, maxPlaytime, yearPublished;
 
-    if (existingGameIndex != -1)
+    if (existing.has_value())
     {
-        Game &existingGame = allGames[existingGameIndex];
+        const Game &existingGame = existing.value();
         printf("\nGame '%s' already exists with the following parameters:\n", existingGame.name.c_str());
         printf("  Min Players: %d\n", existingGame.minPlayers);
         printf("  Max Players: %d\n", existingGame.maxPlayers);
@@ -299,7 +311,7 @@ void Screen::addGame()
 
     Game newGame;
     newGame.id = appState.games.maxKey() + 1;
-    newGame.name = gameName;
+    newGame.name = StringPool::global().intern(gameName);
     newGame.minPlayers = minPlayers;
     newGame.maxPlayers = maxPlayers;
     newGame.minPlaytime = minPlaytime;
@@ -421,15 +433,35 @@ void Screen::addMember()
 
 void Screen::borrowsSummary()
 {
-    Vector<Borrow> allBorrows = appState.getAllBorrows();
+    printf("Show borrows from date (YYYY-MM-DD, press Enter for no limit): ");
+    std::string fromDate = StringHelper::readLine();
+    printf("Show borrows up to date (YYYY-MM-DD, press Enter for no limit): ");
+    std::string toDate = StringHelper::readLine();
+
+    DateHelper::Timestamp from = INT32_MIN;
+    DateHelper::Timestamp to = INT32_MAX;
+    if ((!fromDate.empty() && !DateHelper::parseTimestamp(fromDate, from)) ||
+        (!toDate.empty() && !DateHelper::parseTimestamp(toDate, to)))
+    {
+        printf("Invalid date. Please use the format YYYY-MM-DD.\n");
+        return;
+    }
+    if (!toDate.empty())
+    {
+        to += DateHelper::MINUTES_PER_DAY - 1; // include the whole end day
+    }
+
+    // The log is oldest-first; walk the matching span backwards to list newest first
+    int start, end;
+    appState.findBorrowLogRange(from, to, start, end);
 
-    if (allBorrows.isEmpty())
+    if (start == end)
     {
         printf("No borrow records found.\n");
         return;
     }
 
-    PaginationHelper pagination(allBorrows.getSize(), 10);
+    PaginationHelper pagination(end - start, 10);
 
     while (true)
     {
@@ -450,13 +482,13 @@ void Screen::borrowsSummary()
 
         for (int i = startIdx; i < endIdx; i++)
         {
-            Borrow borrow = allBorrows.get(i);
-            std::string status = (borrow.dateReturned == "N/A" || borrow.dateReturned.empty()) ? "Borrowed" : "Returned";
+            Borrow borrow = appState.getBorrowLogEntry(end - 1 - i);
+            std::string status = borrow.isReturned() ? "Returned" : "Borrowed";
             printf("%-20s %-30s %-30s %-20s %-20s\n",
                    appState.getMemberNameById(borrow.memberId).c_str(),
                    appState.getGameNameById(borrow.gameId).c_str(),
-                   borrow.dateBorrowed.c_str(),
-                   borrow.dateReturned.c_str(),
+                   DateHelper::formatTimestamp(borrow.dateBorrowed).c_str(),
+                   DateHelper::formatTimestamp(borrow.dateReturned).c_str(),
                    status.c_str());
         }
         UIHelper::printSeparator(77);
@@ -490,15 +522,15 @@ void Screen::gamesByPlayerCount()
         return;
     }
 
-    Vector<Game> matchingGames = appState.getGamesForPlayerCount(playerCount);
+    Vector<int> matchingGameIds = appState.getGameIdsForPlayerCount(playerCount);
 
-    if (matchingGames.isEmpty())
+    if (matchingGameIds.isEmpty())
     {
         printf("No games found that can be played with %d player(s).\n", playerCount);
         return;
     }
 
-    PaginationHelper pagination(matchingGames.getSize(), 10);
+    PaginationHelper pagination(matchingGameIds.getSize(), 10);
 
     while (true)
     {
@@ -513,12 +545,12 @@ void Screen::gamesByPlayerCount()
 
         for (int i = startIdx; i < endIdx; i++)
         {
-            Game game = matchingGames.get(i);
-            printf("%d. %s\n", i + 1, game.name.c_str());
+            GameView game = appState.games.view(appState.games.findRow(matchingGameIds[i]));
+            printf("%d. %s\n", i + 1, game.name().c_str());
             printf("   Players: %d-%d | Playtime: %d-%d min | Year: %d\n",
-                   game.minPlayers, game.maxPlayers,
-                   game.minPlaytime, game.maxPlaytime,
-                   game.yearPublished);
+                   game.minPlayers(), game.maxPlayers(),
+                   game.minPlaytime(), game.maxPlaytime(),
+                   game.yearPublished());
         }
         UIHelper::printSeparator();
 
@@ -533,6 +565,81 @@ void Screen::gamesByPlayerCount()
     }
 }
 
+/*
+ * Reads an optional positive number; an empty line means the criterion is not used.
+ * Returns false (after printing an error) if the input is not a positive number.
+ */
+static bool readOptionalCriterion(const char *prompt, int &value)
+{
+    printf("%s (press Enter to skip): ", prompt);
+    std::string input = StringHelper::readLine();
+    value = 0;
+    if (input.empty())
+    {
+        return true;
+    }
+    if (!readIntegerFromString(input, value) || value <= 0)
+    {
+        printf("Invalid input. Please enter a positive number.\n");
+        return false;
+    }
+    return true;
+}
+
+void Screen::filterGames()
+{
+    printf("\n=== Filter Games ===\n");
+
+    GameQuery query;
+    if (!readOptionalCriterion("Number of players", query.players) ||
+        !readOptionalCriterion("Maximum playtime in minutes", query.maxPlaytime) ||
+        !readOptionalCriterion("Published after year", query.publishedAfter))
+    {
+        return;
+    }
+
+    LazySortedView<int, GameRowOrder> matchingGameRows = appState.filterGames(query);
+
+    if (matchingGameRows.isEmpty())
+    {
+        printf("No games match the given filters.\n");
+        return;
+    }
+
+    PaginationHelper pagination(matchingGameRows.getSize(), 10);
+
+    while (true)
+    {
+        int startIdx = pagination.getStartIdx();
+        int endIdx = pagination.getEndIdx();
+
+        printf("\n");
+        UIHelper::printSeparator();
+        printf("Games matching filters (sorted alphabetically)\n");
+        pagination.printPageInfo();
+        UIHelper::printSeparator();
+
+        for (int i = startIdx; i < endIdx; i++)
+        {
+            GameView game = appState.games.view(matchingGameRows.get(i));
+            printf("%d. %s\n", i + 1, game.name().c_str());
+            printf("   Players: %d-%d | Playtime: %d-%d min | Year: %d\n",
+                   game.minPlayers(), game.maxPlayers(),
+                   game.minPlaytime(), game.maxPlaytime(),
+                   game.yearPublished());
+        }
+        UIHelper::printSeparator();
+
+        pagination.printNavigation(false);
+
+        int result = pagination.handleInput(false);
+        if (result == -1)
+        {
+            break; // Quit
+        }
+    }
+}
+
 void Screen::viewReviews()
 {
     printf("\n=== View Game Reviews ===\n");
@@ -540,7 +647,7 @@ void Screen::viewReviews()
     printf("Enter game name to search: ");
     std::string searchTerm = StringHelper::readLine();
 
-    Set<std::string> seenGameNames;
+    Set<StringHandle, ArenaAllocator> seenGameNames;
     Vector<Game> activeGames = appState.searchGames(
         searchTerm,
         [&](const Game &g)
@@ -601,8 +708,8 @@ void Screen::viewReviews()
         Game selectedGameObj = activeGames.get(selectedGame);
         Vector<Review> gameReviews = appState.getReviewsForGameName(selectedGameObj.name);
 
-        Sort::quicksort(gameReviews, [](const Review &a, const Review &b)
-                { return a.reviewId > b.reviewId ? -1 : (a.reviewId < b.reviewId ? 1 : 0); });
+        Sort::radixSortBy(gameReviews, [](const Review &review)
+                          { return review.reviewId; }, true);
 
         printf("\n=== Reviews for Game: %s ===\n\n", selectedGameObj.name.c_str());
 
@@ -623,9 +730,20 @@ void Screen::viewReviews()
         }
         printf("\n");
 
-        float averageRating = appState.getAverageRatingByGameName(selectedGameObj.name);
-        printf("Average rating for %s: %.2f/5 (%d reviews)\n",
-               selectedGameObj.name.c_str(), averageRating, gameReviews.getSize());
+        RatingStats stats = appState.getRatingStatsByGameName(selectedGameObj.name);
+        printf("Average rating for %s: %.2f/5 (%d reviews, std dev %.2f)\n",
+               selectedGameObj.name.c_str(), stats.average(), stats.count, stats.standardDeviation());
+        for (int rating = RatingStats::MAX_RATING; rating >= RatingStats::MIN_RATING; rating--)
+        {
+            int ratingCount = stats.countOf(rating);
+            printf("  %d star%s: %-4d ", rating, rating == 1 ? " " : "s", ratingCount);
+            int barLength = stats.count == 0 ? 0 : ratingCount * 20 / stats.count;
+            for (int i = 0; i < barLength; i++)
+            {
+                printf("#");
+            }
+            printf("\n");
+        }
     }
 }
 
@@ -704,17 +822,7 @@ void Screen::returnGame()
 {
     printf("\n=== Return Board Game ===\n");
 
-    Vector<Borrow> memberBorrows = appState.getMemberBorrows();
-    Vector<Borrow> activeBorrows;
-
-    for (int i = 0; i < memberBorrows.getSize(); i++)
-    {
-        Borrow borrow = memberBorrows.get(i);
-        if (borrow.dateReturned == "N/A" || borrow.dateReturned.empty())
-        {
-            activeBorrows.append(borrow);
-        }
-    }
+    Vector<Borrow> activeBorrows = appState.getActiveMemberBorrows();
 
     if (activeBorrows.isEmpty())
     {
@@ -741,7 +849,8 @@ void Screen::returnGame()
             Borrow borrow = activeBorrows.get(i);
             int pageLocalIdx = i - startIdx;
             printf("%d. Game: %s, Borrowed: %s\n",
-                   pageLocalIdx, appState.getGameNameById(borrow.gameId).c_str(), borrow.dateBorrowed.c_str());
+                   pageLocalIdx, appState.getGameNameById(borrow.gameId).c_str(),
+                   DateHelper::formatTimestamp(borrow.dateBorrowed).c_str());
         }
         UIHelper::printSeparator();
 
@@ -808,8 +917,8 @@ void Screen::myBorrowSummary()
             Borrow borrow = memberBorrows.get(i);
             printf("%-30s %-20s %-20s\n",
                    appState.getGameNameById(borrow.gameId).c_str(),
-                   borrow.dateBorrowed.c_str(),
-                   borrow.dateReturned.empty() ? "Not Returned" : borrow.dateReturned.c_str());
+                   DateHelper::formatTimestamp(borrow.dateBorrowed).c_str(),
+                   borrow.dateReturned == DateHelper::NO_TIMESTAMP ? "Not Returned" : DateHelper::formatTimestamp(borrow.dateReturned).c_str());
         }
         UIHelper::printSeparator();
 
@@ -831,7 +940,7 @@ void Screen::writeReview()
     printf("Enter game name to search: ");
     std::string searchTerm = StringHelper::readLine();
 
-    Set<std::string> seenGameNames;
+    Set<StringHandle, ArenaAllocator> seenGameNames;
     Vector<Game> activeGames = appState.searchGames(
         searchTerm,
         [&](const Game &g)
@@ -921,3 +1030,229 @@ void Screen::writeReview()
         }
     }
 }
+
+void Screen::leaderboards()
+{
+    printf("\n=== Leaderboards ===\n");
+    printf("1. Top rated games\n");
+    printf("2. Most borrowed games\n");
+    printf("3. Trending games (borrows in the last 30 days)\n");
+    printf("Enter your choice: ");
+
+    int choice;
+    if (!readInteger(choice) || choice < 1 || choice > 3)
+    {
+        printf("Invalid choice.\n");
+        return;
+    }
+
+    const char *heading = choice == 1   ? "Top rated games (adjusted for review count)"
+                          : choice == 2 ? "Most borrowed games"
+                                        : "Trending games";
+    const Leaderboard &board = choice == 1   ? appState.getTopRatedGames()
+                               : choice == 2 ? appState.getMostBorrowedGames()
+                                             : appState.getTrendingGames();
+
+    if (board.getSize() == 0)
+    {
+        printf("No games to rank yet.\n");
+        return;
+    }
+
+    PaginationHelper pagination(board.getSize(), 10);
+
+    while (true)
+    {
+        int startIdx = pagination.getStartIdx();
+        int endIdx = pagination.getEndIdx();
+
+        printf("\n");
+        UIHelper::printSeparator();
+        printf("%s\n", heading);
+        pagination.printPageInfo();
+        UIHelper::printSeparator();
+
+        for (int i = startIdx; i < endIdx; i++)
+        {
+            LeaderboardEntry entry = board.at(i);
+            if (choice == 1)
+            {
+                RatingStats stats = appState.getRatingStatsByGameName(entry.title);
+                printf("%d. %s - score %.2f (average %.2f from %d reviews)\n",
+                       i + 1, entry.title.c_str(), entry.score, stats.average(), stats.count);
+            }
+            else
+            {
+                printf("%d. %s - %d borrows\n", i + 1, entry.title.c_str(), (int)entry.score);
+            }
+        }
+        UIHelper::printSeparator();
+
+        pagination.printNavigation(false);
+
+        int result = pagination.handleInput(false);
+        if (result == -1)
+        {
+            break; // Quit
+        }
+    }
+}
+
+void Screen::overdueReport()
+{
+    DateHelper::Timestamp now = DateHelper::getCurrentTimestamp();
+    Vector<Borrow> overdueBorrows = appState.getOverdueBorrows(now);
+
+    if (overdueBorrows.isEmpty())
+    {
+        printf("No overdue loans.\n");
+        return;
+    }
+
+    PaginationHelper pagination(overdueBorrows.getSize(), 10);
+
+    while (true)
+    {
+        int startIdx = pagination.getStartIdx();
+        int endIdx = pagination.getEndIdx();
+
+        printf("\n");
+        UIHelper::printSeparator(77);
+        printf("Overdue Loans (Most Overdue First)\n");
+        pagination.printPageInfo();
+        UIHelper::printSeparator(77);
+        printf("\n");
+        printf("%-20s %-30s %-20s %-20s %-12s\n",
+               "Member", "Game", "Date Borrowed", "Due Date", "Days Overdue");
+        printf("%-20s %-30s %-20s %-20s %-12s\n",
+               "--------------------", "------------------------------", "--------------------",
+               "--------------------", "------------");
+
+        for (int i = startIdx; i < endIdx; i++)
+        {
+            Borrow borrow = overdueBorrows.get(i);
+            DateHelper::Timestamp dueTime = appState.getDueTime(borrow);
+            printf("%-20s %-30s %-20s %-20s %-12d\n",
+                   appState.getMemberNameById(borrow.memberId).c_str(),
+                   appState.getGameNameById(borrow.gameId).c_str(),
+                   DateHelper::formatTimestamp(borrow.dateBorrowed).c_str(),
+                   DateHelper::formatTimestamp(dueTime).c_str(),
+                   (now - dueTime) / DateHelper::MINUTES_PER_DAY);
+        }
+        UIHelper::printSeparator(77);
+
+        pagination.printNavigation(false);
+
+        int result = pagination.handleInput(false);
+        if (result == -1)
+        {
+            break; // Quit
+        }
+    }
+}
+
+void Screen::gameLoanHistory()
+{
+    printf("\n=== Game Loan History ===\n");
+
+    printf("Enter game name to search: ");
+    std::string searchTerm = StringHelper::readLine();
+
+    // Removed copies are included, since their history is still of interest
+    Vector<Game> matchingGames = appState.searchGames(searchTerm);
+
+    if (matchingGames.isEmpty())
+    {
+        printf("No games found matching your search.\n");
+        return;
+    }
+
+    PaginationHelper pagination(matchingGames.getSize(), 10);
+    int selectedGame = -1;
+
+    while (true)
+    {
+        int startIdx = pagination.getStartIdx();
+        int endIdx = pagination.getEndIdx();
+
+        printf("\n");
+        UIHelper::printSeparator();
+        printf("Matching games for '%s'\n", searchTerm.c_str());
+        pagination.printPageInfo();
+        UIHelper::printSeparator();
+
+        for (int i = startIdx; i < endIdx; i++)
+        {
+            Game game = matchingGames.get(i);
+            int pageLocalIdx = i - startIdx;
+            printf("%d. Name: %s, ID: %d%s\n",
+                   pageLocalIdx, game.name.c_str(), game.id, game.isDeleted ? " (removed)" : "");
+        }
+        UIHelper::printSeparator();
+
+        pagination.printNavigation(true);
+
+        int result = pagination.handleInput(true);
+        if (result == -1)
+        {
+            return; // Quit
+        }
+        else if (result >= 0)
+        {
+            selectedGame = pagination.toGlobalIndex(result);
+            break;
+        }
+    }
+
+    Game game = matchingGames.get(selectedGame);
+
+    LoanStats stats = appState.getGameLoanStats(game.id);
+    printf("\nTotal loans: %d\n", stats.totalLoans);
+    if (stats.totalLoans > 0)
+    {
+        printf("Average loan length: %.1f days\n", stats.averageLoanDays());
+        printf("Last borrowed: %s by %s\n\n",
+               DateHelper::formatTimestamp(stats.lastBorrowed).c_str(),
+               appState.getMemberNameById(stats.lastBorrowerId).c_str());
+    }
+
+    printf("Enter start date (YYYY-MM-DD): ");
+    std::string fromDate = StringHelper::readLine();
+    printf("Enter end date (YYYY-MM-DD, press Enter for the same day): ");
+    std::string toDate = StringHelper::readLine();
+    if (toDate.empty())
+    {
+        toDate = fromDate;
+    }
+
+    DateHelper::Timestamp from, to;
+    if (!DateHelper::parseTimestamp(fromDate, from) || !DateHelper::parseTimestamp(toDate, to) || to < from)
+    {
+        printf("Invalid date range. Please use the format YYYY-MM-DD.\n");
+        return;
+    }
+    to += DateHelper::MINUTES_PER_DAY; // include the whole end day
+
+    Vector<Borrow> loans = appState.getGameLoansBetween(game.id, from, to);
+
+    printf("\n=== Loans of %s (ID %d) from %s to %s ===\n\n",
+           game.name.c_str(), game.id, fromDate.c_str(), toDate.c_str());
+
+    if (loans.isEmpty())
+    {
+        printf("The game was not on loan during this period.\n");
+        return;
+    }
+
+    printf("%-20s %-20s %-20s\n", "Member", "Date Borrowed", "Date Returned");
+    printf("%-20s %-20s %-20s\n", "--------------------", "--------------------", "--------------------");
+    for (int i = 0; i < loans.getSize(); i++)
+    {
+        Borrow borrow = loans.get(i);
+        printf("%-20s %-20s %-20s\n",
+               appState.getMemberNameById(borrow.memberId).c_str(),
+               DateHelper::formatTimestamp(borrow.dateBorrowed).c_str(),
+               DateHelper::formatTimestamp(borrow.dateReturned).c_str());
+    }
+    printf("\nOn loan for %.1f%% of this period.\n", appState.getGameUtilisation(game.id, from, to));
+}
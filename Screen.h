@@ -22,6 +22,10 @@ public:
     void borrowsSummary();
     void gamesByPlayerCount();
     void viewReviews();
+    void filterGames();
+    void leaderboards();
+    void overdueReport();
+    void gameLoanHistory();
 
     void memberMenu();
     void borrowGame();
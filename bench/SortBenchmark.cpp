@@ -0,0 +1,243 @@
+/*
+ * Benchmark for lib/Sort.h: times Sort::quicksort (introsort), Sort::stableSort and
+ * Sort::parallelSort against the original recursive median-of-three quicksort on sorted, reversed,
+ * duplicate-heavy and random input, and checks every result is sorted.
+ * parallelSort only uses threads from Sort::PARALLEL_SORT_THRESHOLD elements on a multi-core machine.
+ *
+ * Not part of NPTTGC.sln (it has its own main). Build it from the repository root with
+ * optimisations on, e.g. from a Developer Command Prompt:
+ *   cl /std:c++17 /O2 /EHsc /I. bench\SortBenchmark.cpp
+ * Usage: SortBenchmark [element count, default 200000] [runs per case, default 3]
+ * Each figure is the fastest of the runs, in milliseconds.
+ */
+
+#include "lib/Vector.h"
+#include "lib/Sort.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+/*
+ * The quicksort lib/Sort.h shipped before the introsort: Lomuto partition after median-of-three,
+ * recursion on both sides, three copies per swap. Kept here only as the baseline.
+ */
+namespace BaselineSort
+{
+    template <typename T, typename Compare>
+    void medianOfThree(Vector<T> &vec, int low, int high, Compare compare)
+    {
+        int mid = (high + low) / 2;
+
+        if (compare(vec[mid], vec[low]) < 0)
+        {
+            T temp = vec[low];
+            vec[low] = vec[mid];
+            vec[mid] = temp;
+        }
+        if (compare(vec[high], vec[low]) < 0)
+        {
+            T temp = vec[low];
+            vec[low] = vec[high];
+            vec[high] = temp;
+        }
+        if (compare(vec[high], vec[mid]) < 0)
+        {
+            T temp = vec[mid];
+            vec[mid] = vec[high];
+            vec[high] = temp;
+        }
+
+        T temp = vec[mid];
+        vec[mid] = vec[high];
+        vec[high] = temp;
+    }
+
+    template <typename T, typename Compare>
+    int partition(Vector<T> &vec, int low, int high, Compare compare)
+    {
+        medianOfThree(vec, low, high, compare);
+
+        T pivot = vec[high];
+        int i = low - 1;
+
+        for (int j = low; j < high; j++)
+        {
+            if (compare(vec[j], pivot) < 0)
+            {
+                i++;
+                T temp = vec[i];
+                vec[i] = vec[j];
+                vec[j] = temp;
+            }
+        }
+
+        T temp = vec[i + 1];
+        vec[i + 1] = vec[high];
+        vec[high] = temp;
+
+        return i + 1;
+    }
+
+    template <typename T, typename Compare>
+    void quicksortHelper(Vector<T> &vec, int low, int high, Compare compare)
+    {
+        if (low < high)
+        {
+            int pivotIndex = partition(vec, low, high, compare);
+            quicksortHelper(vec, low, pivotIndex - 1, compare);
+            quicksortHelper(vec, pivotIndex + 1, high, compare);
+        }
+    }
+
+    template <typename T, typename Compare>
+    void quicksort(Vector<T> &vec, Compare compare)
+    {
+        if (vec.getSize() > 1)
+        {
+            quicksortHelper(vec, 0, vec.getSize() - 1, compare);
+        }
+    }
+}
+
+// The baseline recurses once per element on duplicate-heavy input, so it is skipped there
+// above this size rather than risk overflowing the stack
+static const int BASELINE_DUPLICATES_LIMIT = 50000;
+
+static int compareInts(const int &a, const int &b)
+{
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+enum Shape
+{
+    SORTED,
+    REVERSED,
+    DUPLICATES, // only four distinct values, like many borrows in the same minute
+    RANDOM,
+    SHAPE_COUNT
+};
+
+static const char *SHAPE_NAMES[SHAPE_COUNT] = {"sorted", "reversed", "duplicates", "random"};
+
+static Vector<int> makeInput(Shape shape, int count, std::mt19937 &rng)
+{
+    Vector<int> values(count);
+    for (int i = 0; i < count; i++)
+    {
+        switch (shape)
+        {
+        case SORTED:
+            values.append(i);
+            break;
+        case REVERSED:
+            values.append(count - i);
+            break;
+        case DUPLICATES:
+            values.append((int)(rng() % 4));
+            break;
+        default:
+            values.append((int)rng());
+            break;
+        }
+    }
+    return values;
+}
+
+static bool isSorted(const Vector<int> &values)
+{
+    for (int i = 1; i < values.getSize(); i++)
+    {
+        if (values[i - 1] > values[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Times a sort on fresh copies of an input.
+ * Returns: the fastest run in milliseconds, or -1 if any run left the data unsorted
+ */
+template <typename SortFunction>
+static double timeSort(const Vector<int> &input, int runs, SortFunction sort)
+{
+    double best = 0;
+    for (int run = 0; run < runs; run++)
+    {
+        Vector<int> values = input;
+        auto start = std::chrono::steady_clock::now();
+        sort(values);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (!isSorted(values))
+        {
+            return -1;
+        }
+        if (run == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+static void printTime(double milliseconds)
+{
+    if (milliseconds < 0)
+    {
+        printf(" %12s", "UNSORTED");
+    }
+    else
+    {
+        printf(" %12.2f", milliseconds);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : 200000;
+    int runs = argc > 2 ? atoi(argv[2]) : 3;
+    if (count < 1 || runs < 1)
+    {
+        printf("Usage: %s [element count] [runs per case]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%d ints, fastest of %d runs (ms)\n", count, runs);
+    printf("%-12s %12s %12s %12s %12s\n", "input", "baseline", "quicksort", "stableSort", "parallelSort");
+
+    std::mt19937 rng(12345);
+    bool failed = false;
+    for (int shape = 0; shape < SHAPE_COUNT; shape++)
+    {
+        Vector<int> input = makeInput((Shape)shape, count, rng);
+        printf("%-12s", SHAPE_NAMES[shape]);
+
+        if (shape == DUPLICATES && count > BASELINE_DUPLICATES_LIMIT)
+        {
+            printf(" %12s", "skipped");
+        }
+        else
+        {
+            double baseline = timeSort(input, runs, [](Vector<int> &values)
+                                       { BaselineSort::quicksort(values, compareInts); });
+            failed = failed || baseline < 0;
+            printTime(baseline);
+        }
+
+        double introsort = timeSort(input, runs, [](Vector<int> &values)
+                                    { Sort::quicksort(values, compareInts); });
+        double stable = timeSort(input, runs, [](Vector<int> &values)
+                                 { Sort::stableSort(values, compareInts); });
+        double parallel = timeSort(input, runs, [](Vector<int> &values)
+                                   { Sort::parallelSort(values, compareInts); });
+        failed = failed || introsort < 0 || stable < 0 || parallel < 0;
+        printTime(introsort);
+        printTime(stable);
+        printTime(parallel);
+        printf("\n");
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+#include "AtomicFile.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+AtomicFile::AtomicFile(const std::string &path)
+    : targetPath(path), tempPath(tempPathFor(path))
+{
+    file = fopen(tempPath.c_str(), "wb");
+}
+
+AtomicFile::~AtomicFile()
+{
+    abort();
+}
+
+bool AtomicFile::isOpen() const
+{
+    return file != nullptr;
+}
+
+FILE *AtomicFile::get() const
+{
+    return file;
+}
+
+bool AtomicFile::commit()
+{
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    // The data must be on disk before the rename makes it visible, otherwise a crash
+    // could leave the target pointing at a file whose contents were never written
+    bool synced = fflush(file) == 0;
+#ifdef _WIN32
+    synced = synced && _commit(_fileno(file)) == 0;
+#else
+    synced = synced && fsync(fileno(file)) == 0;
+#endif
+    bool closed = fclose(file) == 0;
+    file = nullptr;
+
+    if (!synced || !closed)
+    {
+        remove(tempPath.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExA(tempPath.c_str(), targetPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        remove(tempPath.c_str());
+        return false;
+    }
+#else
+    if (rename(tempPath.c_str(), targetPath.c_str()) != 0)
+    {
+        remove(tempPath.c_str());
+        return false;
+    }
+
+    // Persist the directory entry so the rename itself survives a crash
+    size_t slash = targetPath.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : targetPath.substr(0, slash + 1);
+    int dirFd = open(directory.c_str(), O_RDONLY);
+    if (dirFd >= 0)
+    {
+        fsync(dirFd);
+        close(dirFd);
+    }
+#endif
+    return true;
+}
+
+void AtomicFile::abort()
+{
+    if (file != nullptr)
+    {
+        fclose(file);
+        file = nullptr;
+        remove(tempPath.c_str());
+    }
+}
+
+std::string AtomicFile::tempPathFor(const std::string &path)
+{
+    return path + ".tmp";
+}
+
+bool AtomicFile::recover(const std::string &path)
+{
+    return remove(tempPathFor(path).c_str()) == 0;
+}
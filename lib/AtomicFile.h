@@ -0,0 +1,72 @@
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+
+#include <string>
+#include <cstdio>
+
+/*
+ * Crash-safe file replacement.
+ * Output is written to "<path>.tmp", flushed to disk and then renamed over the target in one step,
+ * so readers (and the next startup after a crash) only ever see the old or the new complete file.
+ */
+class AtomicFile
+{
+private:
+    std::string targetPath;
+    std::string tempPath;
+    FILE *file;
+
+public:
+    /**
+     * Opens the temporary file that will replace the target on commit
+     * @param path Path of the file to replace
+     */
+    AtomicFile(const std::string &path);
+
+    /**
+     * Discards the temporary file if commit() was never called
+     */
+    ~AtomicFile();
+
+    AtomicFile(const AtomicFile &) = delete;
+    AtomicFile &operator=(const AtomicFile &) = delete;
+
+    /**
+     * Checks whether the temporary file was opened successfully
+     * @return true if the file can be written
+     */
+    bool isOpen() const;
+
+    /**
+     * Gets the stream to write the new contents to
+     * @return The temporary file stream, or nullptr if it could not be opened
+     */
+    FILE *get() const;
+
+    /**
+     * Flushes and syncs the temporary file, then atomically renames it over the target
+     * @return true if the target now holds the new contents, false if it was left untouched
+     */
+    bool commit();
+
+    /**
+     * Closes and deletes the temporary file, leaving the target untouched
+     */
+    void abort();
+
+    /**
+     * Gets the temporary path used while replacing a file
+     * @param path Path of the file being replaced
+     * @return The path of its temporary file
+     */
+    static std::string tempPathFor(const std::string &path);
+
+    /**
+     * Removes a temporary file left behind by a save that was interrupted before its rename
+     * @param path Path of the file that was being replaced
+     * @return true if a leftover temporary file was found and removed
+     */
+    static bool recover(const std::string &path);
+};
+
+#endif
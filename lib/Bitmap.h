@@ -0,0 +1,578 @@
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <cstdint>
+#include <climits>
+#include "Vector.h"
+#include "Search.h"
+
+/*
+ * Compressed bitmap of non-negative integers in the style of Roaring bitmaps.
+ * Values are split by their high 16 bits into containers. A container holds its low 16 bits
+ * either as a sorted array (while it has at most 4096 values) or as a 65536-bit bitset,
+ * so both sparse and dense sets stay compact and AND/OR work container by container.
+ */
+class Bitmap
+{
+private:
+    static const int ARRAY_LIMIT = 4096;
+    static const int WORD_COUNT = 1024;
+
+    struct Container
+    {
+        int key;
+        int cardinality;
+        bool dense;
+        Vector<unsigned short> values;
+        Vector<uint64_t> words;
+
+        Container() : key(0), cardinality(0), dense(false), values(4), words(1) {}
+    };
+
+    Vector<Container> containers;
+
+    static int popcount(uint64_t x)
+    {
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return (int)((x * 0x0101010101010101ULL) >> 56);
+    }
+
+    static bool testBit(const Container &c, int low)
+    {
+        return (c.words[low >> 6] >> (low & 63)) & 1;
+    }
+
+    /*
+     * Finds a value in a sorted array container.
+     * Returns: the index of the value, or -(insertion point) - 1 if it is absent
+     */
+    static int findValue(const Container &c, int low)
+    {
+        int left = 0, right = c.values.getSize();
+        while (left < right)
+        {
+            int mid = (left + right) / 2;
+            if (c.values[mid] < low)
+                left = mid + 1;
+            else
+                right = mid;
+        }
+        return (left < c.values.getSize() && c.values[left] == low) ? left : -left - 1;
+    }
+
+    static void toDense(Container &c)
+    {
+        c.words = Vector<uint64_t>(WORD_COUNT);
+        for (int i = 0; i < WORD_COUNT; i++)
+        {
+            c.words.append(0);
+        }
+        for (int i = 0; i < c.values.getSize(); i++)
+        {
+            int low = c.values[i];
+            c.words[low >> 6] |= 1ULL << (low & 63);
+        }
+        c.values = Vector<unsigned short>(4);
+        c.dense = true;
+    }
+
+    static void toArray(Container &c)
+    {
+        Vector<unsigned short> values(c.cardinality > 0 ? c.cardinality : 1);
+        for (int w = 0; w < WORD_COUNT; w++)
+        {
+            uint64_t word = c.words[w];
+            while (word != 0)
+            {
+                uint64_t lowest = word & (~word + 1);
+                values.append((unsigned short)(w * 64 + popcount(lowest - 1)));
+                word ^= lowest;
+            }
+        }
+        c.values = values;
+        c.words = Vector<uint64_t>(1);
+        c.dense = false;
+    }
+
+    /*
+     * Finds the container for a high-16-bit key.
+     * Returns: the index of the container, or -(insertion point) - 1 if there is none
+     */
+    int findContainer(int key) const
+    {
+        int left = 0, right = containers.getSize();
+        while (left < right)
+        {
+            int mid = (left + right) / 2;
+            if (containers[mid].key < key)
+                left = mid + 1;
+            else
+                right = mid;
+        }
+        return (left < containers.getSize() && containers[left].key == key) ? left : -left - 1;
+    }
+
+    static Container intersectContainers(const Container &a, const Container &b)
+    {
+        Container result;
+        result.key = a.key;
+
+        if (a.dense && b.dense)
+        {
+            result.words = Vector<uint64_t>(WORD_COUNT);
+            for (int i = 0; i < WORD_COUNT; i++)
+            {
+                uint64_t word = a.words[i] & b.words[i];
+                result.words.append(word);
+                result.cardinality += popcount(word);
+            }
+            result.dense = true;
+            if (result.cardinality <= ARRAY_LIMIT)
+            {
+                toArray(result);
+            }
+        }
+        else if (a.dense || b.dense)
+        {
+            const Container &sparse = a.dense ? b : a;
+            const Container &dense = a.dense ? a : b;
+            for (int i = 0; i < sparse.values.getSize(); i++)
+            {
+                if (testBit(dense, sparse.values[i]))
+                {
+                    result.values.append(sparse.values[i]);
+                }
+            }
+            result.cardinality = result.values.getSize();
+        }
+        else
+        {
+            int i = 0, j = 0;
+            while (i < a.values.getSize() && j < b.values.getSize())
+            {
+                if (a.values[i] < b.values[j])
+                    i++;
+                else if (a.values[i] > b.values[j])
+                    j++;
+                else
+                {
+                    result.values.append(a.values[i]);
+                    i++;
+                    j++;
+                }
+            }
+            result.cardinality = result.values.getSize();
+        }
+        return result;
+    }
+
+    static Container uniteContainers(const Container &a, const Container &b)
+    {
+        Container result;
+        result.key = a.key;
+
+        if (!a.dense && !b.dense)
+        {
+            int i = 0, j = 0;
+            while (i < a.values.getSize() || j < b.values.getSize())
+            {
+                if (j >= b.values.getSize() || (i < a.values.getSize() && a.values[i] < b.values[j]))
+                    result.values.append(a.values[i++]);
+                else if (i >= a.values.getSize() || b.values[j] < a.values[i])
+                    result.values.append(b.values[j++]);
+                else
+                {
+                    result.values.append(a.values[i]);
+                    i++;
+                    j++;
+                }
+            }
+            result.cardinality = result.values.getSize();
+            if (result.cardinality > ARRAY_LIMIT)
+            {
+                toDense(result);
+            }
+            return result;
+        }
+
+        result = a.dense ? a : b;
+        const Container &other = a.dense ? b : a;
+        if (other.dense)
+        {
+            for (int i = 0; i < WORD_COUNT; i++)
+            {
+                result.words[i] |= other.words[i];
+            }
+        }
+        else
+        {
+            for (int i = 0; i < other.values.getSize(); i++)
+            {
+                int low = other.values[i];
+                result.words[low >> 6] |= 1ULL << (low & 63);
+            }
+        }
+        result.cardinality = 0;
+        for (int i = 0; i < WORD_COUNT; i++)
+        {
+            result.cardinality += popcount(result.words[i]);
+        }
+        return result;
+    }
+
+public:
+    Bitmap() : containers(1) {}
+
+    /*
+     * Adds a value to the bitmap.
+     * Parameters: value - the non-negative value to add
+     * Returns: true if the value was added, false if it was already present
+     */
+    bool add(int value)
+    {
+        int key = value >> 16;
+        int low = value & 0xFFFF;
+        int index = findContainer(key);
+        if (index < 0)
+        {
+            index = -index - 1;
+            Container created;
+            created.key = key;
+            containers.insert(index, created);
+        }
+
+        Container &c = containers[index];
+        if (c.dense)
+        {
+            if (testBit(c, low))
+                return false;
+            c.words[low >> 6] |= 1ULL << (low & 63);
+        }
+        else
+        {
+            int slot = findValue(c, low);
+            if (slot >= 0)
+                return false;
+            c.values.insert(-slot - 1, (unsigned short)low);
+        }
+
+        c.cardinality++;
+        if (!c.dense && c.cardinality > ARRAY_LIMIT)
+        {
+            toDense(c);
+        }
+        return true;
+    }
+
+    /*
+     * Removes a value from the bitmap.
+     * Parameters: value - the value to remove
+     * Returns: true if the value was removed, false if it was not present
+     */
+    bool remove(int value)
+    {
+        int index = findContainer(value >> 16);
+        if (index < 0)
+            return false;
+
+        Container &c = containers[index];
+        int low = value & 0xFFFF;
+        if (c.dense)
+        {
+            if (!testBit(c, low))
+                return false;
+            c.words[low >> 6] &= ~(1ULL << (low & 63));
+        }
+        else
+        {
+            int slot = findValue(c, low);
+            if (slot < 0)
+                return false;
+            c.values.remove(slot);
+        }
+
+        c.cardinality--;
+        if (c.cardinality == 0)
+        {
+            containers.remove(index);
+        }
+        else if (c.dense && c.cardinality <= ARRAY_LIMIT / 2)
+        {
+            toArray(c);
+        }
+        return true;
+    }
+
+    /*
+     * Checks whether a value is in the bitmap.
+     * Parameters: value - the value to check for
+     * Returns: true if the value is present, false otherwise
+     */
+    bool contains(int value) const
+    {
+        int index = findContainer(value >> 16);
+        if (index < 0)
+            return false;
+        const Container &c = containers[index];
+        int low = value & 0xFFFF;
+        return c.dense ? testBit(c, low) : findValue(c, low) >= 0;
+    }
+
+    /*
+     * Returns the number of values in the bitmap.
+     * Parameters: none
+     * Returns: the count of values
+     */
+    int getCardinality() const
+    {
+        int total = 0;
+        for (int i = 0; i < containers.getSize(); i++)
+        {
+            total += containers[i].cardinality;
+        }
+        return total;
+    }
+
+    /*
+     * Checks whether the bitmap contains any values.
+     * Parameters: none
+     * Returns: true if the bitmap is empty, false otherwise
+     */
+    bool isEmpty() const
+    {
+        return containers.isEmpty();
+    }
+
+    /*
+     * Removes all values from the bitmap.
+     * Parameters: none
+     * Returns: nothing
+     */
+    void clear()
+    {
+        containers = Vector<Container>(1);
+    }
+
+    /*
+     * Computes the intersection (AND) of this bitmap with another.
+     * Parameters: other - the bitmap to intersect with
+     * Returns: a new bitmap holding the values present in both
+     */
+    Bitmap intersect(const Bitmap &other) const
+    {
+        Bitmap result;
+        int i = 0, j = 0;
+        while (i < containers.getSize() && j < other.containers.getSize())
+        {
+            const Container &a = containers[i];
+            const Container &b = other.containers[j];
+            if (a.key < b.key)
+                i++;
+            else if (a.key > b.key)
+                j++;
+            else
+            {
+                Container c = intersectContainers(a, b);
+                if (c.cardinality > 0)
+                {
+                    result.containers.append(c);
+                }
+                i++;
+                j++;
+            }
+        }
+        return result;
+    }
+
+    /*
+     * Computes the union (OR) of this bitmap with another.
+     * Parameters: other - the bitmap to unite with
+     * Returns: a new bitmap holding the values present in either
+     */
+    Bitmap unite(const Bitmap &other) const
+    {
+        Bitmap result;
+        int i = 0, j = 0;
+        while (i < containers.getSize() || j < other.containers.getSize())
+        {
+            if (j >= other.containers.getSize() ||
+                (i < containers.getSize() && containers[i].key < other.containers[j].key))
+                result.containers.append(containers[i++]);
+            else if (i >= containers.getSize() || other.containers[j].key < containers[i].key)
+                result.containers.append(other.containers[j++]);
+            else
+            {
+                result.containers.append(uniteContainers(containers[i], other.containers[j]));
+                i++;
+                j++;
+            }
+        }
+        return result;
+    }
+
+    /*
+     * Calls a function for each value in ascending order.
+     * Parameters: func - a function that takes a value
+     * Returns: nothing
+     */
+    template <typename Func>
+    void forEach(Func func) const
+    {
+        for (int i = 0; i < containers.getSize(); i++)
+        {
+            const Container &c = containers[i];
+            int base = c.key << 16;
+            if (c.dense)
+            {
+                for (int w = 0; w < WORD_COUNT; w++)
+                {
+                    uint64_t word = c.words[w];
+                    while (word != 0)
+                    {
+                        uint64_t lowest = word & (~word + 1);
+                        func(base + w * 64 + popcount(lowest - 1));
+                        word ^= lowest;
+                    }
+                }
+            }
+            else
+            {
+                for (int k = 0; k < c.values.getSize(); k++)
+                {
+                    func(base + c.values[k]);
+                }
+            }
+        }
+    }
+
+    /*
+     * Extracts all values in ascending order.
+     * Parameters: none
+     * Returns: a Vector containing every value in the bitmap
+     */
+    Vector<int> toVector() const
+    {
+        int cardinality = getCardinality();
+        Vector<int> result(cardinality > 0 ? cardinality : 1);
+        forEach([&](int value)
+                { result.append(value); });
+        return result;
+    }
+};
+
+/*
+ * Bucketed bitmap index over one integer attribute of a set of rows.
+ * Each bucket [bounds[i], bounds[i + 1]) keeps a bitmap of the rows whose value falls in it
+ * (the first bucket is open below and the last open above). A range query ORs the buckets it
+ * fully covers and checks the rows of the at most two partially covered buckets individually.
+ */
+class BitmapRangeIndex
+{
+private:
+    Vector<int> bounds;
+    EytzingerArray<int> boundsLayout; // bounds again, laid out for the per-row bucket lookups
+    Vector<Bitmap> buckets;
+
+    static int compareBound(int bound, int value)
+    {
+        return bound < value ? -1 : (bound > value ? 1 : 0);
+    }
+
+    int bucketOf(int value) const
+    {
+        int bucket = boundsLayout.upperBound(value, compareBound) - 1;
+        return bucket > 0 ? bucket : 0;
+    }
+
+public:
+    BitmapRangeIndex() {}
+
+    /*
+     * Creates an index with the given bucket boundaries.
+     * Parameters: lowerBounds - ascending lower bounds of each bucket, count - number of buckets
+     */
+    BitmapRangeIndex(const int *lowerBounds, int count)
+        : bounds(count), buckets(count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            bounds.append(lowerBounds[i]);
+            buckets.append(Bitmap());
+        }
+        boundsLayout = EytzingerArray<int>(bounds);
+    }
+
+    /*
+     * Records the value of a row.
+     * Parameters: row - the row number, value - the row's attribute value
+     * Returns: nothing
+     */
+    void add(int row, int value)
+    {
+        buckets[bucketOf(value)].add(row);
+    }
+
+    /*
+     * Forgets a row previously recorded with the given value.
+     * Parameters: row - the row number, value - the value the row was added with
+     * Returns: nothing
+     */
+    void remove(int row, int value)
+    {
+        buckets[bucketOf(value)].remove(row);
+    }
+
+    /*
+     * Removes every row from the index, keeping the bucket boundaries.
+     * Parameters: none
+     * Returns: nothing
+     */
+    void clear()
+    {
+        for (int i = 0; i < buckets.getSize(); i++)
+        {
+            buckets[i].clear();
+        }
+    }
+
+    /*
+     * Finds all rows whose value lies in [low, high].
+     * Parameters: low, high - inclusive value range,
+     *             valueOf - function returning a row's current value (used for partial buckets)
+     * Returns: a bitmap of the matching rows
+     */
+    template <typename Getter>
+    Bitmap range(int low, int high, Getter valueOf) const
+    {
+        Bitmap result;
+        if (low > high || buckets.isEmpty())
+            return result;
+
+        int first = bucketOf(low);
+        int last = bucketOf(high);
+        for (int b = first; b <= last; b++)
+        {
+            bool coversStart = b > 0 ? bounds[b] >= low : low == INT_MIN;
+            bool coversEnd = b + 1 < bounds.getSize() ? bounds[b + 1] - 1 <= high : high == INT_MAX;
+            if (coversStart && coversEnd)
+            {
+                result = result.unite(buckets[b]);
+            }
+            else
+            {
+                buckets[b].forEach([&](int row)
+                                   {
+                    int value = valueOf(row);
+                    if (value >= low && value <= high)
+                    {
+                        result.add(row);
+                    } });
+            }
+        }
+        return result;
+    }
+};
+
+#endif
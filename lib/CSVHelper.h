@@ -2,10 +2,18 @@
 #define CSVHELPER_H
 
 #include <string>
+#include <string_view>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
 #include <fstream>
 #include <functional>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
 #include "Vector.h"
 #include "Dictionary.h"
+#include "AtomicFile.h"
 
 /// Splits a CSV line into fields, handling quoted values and escaped quotes.
 inline Vector<std::string> splitCSVLine(const std::string &line)
@@ -54,37 +62,181 @@ inline std::string trim(const std::string &str)
 	return str.substr(first, (last - first + 1));
 }
 
-/// Escapes a field for CSV output by quoting if necessary and doubling internal quotes.
-inline std::string escapeCSVField(const std::string &field)
+/// Streaming CSV writer that formats rows into a reusable buffer and flushes it with one write per buffer.
+/// Rows go to a temporary file that only replaces the target when close() succeeds.
+class CSVWriter
 {
-	bool needsQuotes = false;
-	for (char c : field)
+private:
+	static const size_t BUFFER_CAPACITY = 1 << 16;
+
+	AtomicFile output;
+	FILE *file;
+	char *buffer;
+	size_t length;
+	bool rowStarted;
+	bool failed;
+
+	void flush()
 	{
-		if (c == ',' || c == '"' || c == '\n')
+		if (length > 0 && fwrite(buffer, 1, length, file) != length)
 		{
-			needsQuotes = true;
-			break;
+			failed = true;
 		}
+		length = 0;
 	}
 
-	if (!needsQuotes)
-		return field;
+	void reserve(size_t count)
+	{
+		if (length + count > BUFFER_CAPACITY)
+		{
+			flush();
+		}
+	}
 
-	std::string escaped = "\"";
-	for (char c : field)
+	void append(const char *data, size_t count)
 	{
-		if (c == '"')
-			escaped += "\"\"";
-		else
-			escaped += c;
+		if (count > BUFFER_CAPACITY)
+		{
+			flush();
+			if (fwrite(data, 1, count, file) != count)
+			{
+				failed = true;
+			}
+			return;
+		}
+		reserve(count);
+		memcpy(buffer + length, data, count);
+		length += count;
 	}
-	escaped += "\"";
-	return escaped;
-}
+
+	void separator()
+	{
+		if (rowStarted)
+		{
+			reserve(1);
+			buffer[length++] = ',';
+		}
+		rowStarted = true;
+	}
+
+	/// Checks 16 bytes at a time whether a field contains a character that forces quoting (',', '"' or newline).
+	static bool needsQuoting(const char *data, size_t size)
+	{
+		size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		const __m128i comma = _mm_set1_epi8(',');
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i newline = _mm_set1_epi8('\n');
+		for (; i + 16 <= size; i += 16)
+		{
+			__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+			__m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, quote)),
+										_mm_cmpeq_epi8(chunk, newline));
+			if (_mm_movemask_epi8(hits) != 0)
+				return true;
+		}
+#endif
+		for (; i < size; i++)
+		{
+			if (data[i] == ',' || data[i] == '"' || data[i] == '\n')
+				return true;
+		}
+		return false;
+	}
+
+public:
+	CSVWriter(const std::string &filepath)
+		: output(filepath), file(output.get()), buffer(new char[BUFFER_CAPACITY]), length(0), rowStarted(false), failed(false)
+	{
+	}
+
+	~CSVWriter()
+	{
+		delete[] buffer;
+	}
+
+	CSVWriter(const CSVWriter &) = delete;
+	CSVWriter &operator=(const CSVWriter &) = delete;
+
+	/// Checks whether the output file was opened successfully.
+	bool isOpen() const
+	{
+		return file != nullptr;
+	}
+
+	/// Writes a line as-is (used for the header row).
+	void writeLine(const std::string &line)
+	{
+		append(line.data(), line.size());
+		endRow();
+	}
+
+	/// Writes a text field, quoting it and doubling internal quotes only when needed.
+	void writeField(std::string_view field)
+	{
+		separator();
+		const char *data = field.data();
+		size_t size = field.size();
+
+		if (!needsQuoting(data, size))
+		{
+			append(data, size);
+			return;
+		}
+
+		append("\"", 1);
+		size_t start = 0;
+		const char *quote;
+		while ((quote = static_cast<const char *>(memchr(data + start, '"', size - start))) != nullptr)
+		{
+			size_t quoteIdx = quote - data;
+			append(data + start, quoteIdx + 1 - start);
+			append("\"", 1);
+			start = quoteIdx + 1;
+		}
+		append(data + start, size - start);
+		append("\"", 1);
+	}
+
+	/// Writes an integer field without going through a temporary string.
+	void writeField(int value)
+	{
+		separator();
+		reserve(12);
+		std::to_chars_result result = std::to_chars(buffer + length, buffer + BUFFER_CAPACITY, value);
+		length = result.ptr - buffer;
+	}
+
+	/// Terminates the current row.
+	void endRow()
+	{
+		reserve(1);
+		buffer[length++] = '\n';
+		rowStarted = false;
+	}
+
+	/// Flushes any buffered output and atomically replaces the target file with it.
+	/// If any write failed, the temporary file is discarded and the target is left untouched.
+	/// @return true if the target file now holds every row written
+	bool close()
+	{
+		if (file == nullptr)
+			return false;
+		flush();
+		file = nullptr;
+		if (failed)
+		{
+			output.abort();
+			return false;
+		}
+		return output.commit();
+	}
+};
 
 /// Loads objects from a CSV file using a builder function to construct each object from CSV fields.
-template <typename T>
-Vector<T> buildFromFile(const std::string &filepath, std::function<T(const Vector<std::string> &)> builder)
+/// The builder may be any callable (function, lambda or std::function); it is inlined when possible.
+template <typename T, typename Builder>
+Vector<T> buildFromFile(const std::string &filepath, Builder builder)
 {
 	Vector<T> result;
 	std::ifstream file(filepath.c_str());
@@ -109,17 +261,18 @@ Vector<T> buildFromFile(const std::string &filepath, std::function<T(const Vecto
 	return result;
 }
 
-/// Loads objects from a CSV file and builds a Dictionary using a key extraction function.
-template <typename K, typename T>
-Dictionary<K, T> buildDictFromFile(const std::string &filepath, std::function<T(const Vector<std::string> &)> builder, std::function<K(const T &)> keyFunc)
+/// Loads objects from a CSV file into an existing Dictionary using a key extraction function.
+/// Filling the table in place means its nodes are allocated once, by its own allocator.
+/// The builder and key function may be any callables.
+template <typename K, typename T, template <typename> class Allocator, typename Builder, typename KeyFunc>
+void loadDictFromFile(const std::string &filepath, Dictionary<K, T, Allocator> &result, Builder builder, KeyFunc keyFunc)
 {
-	Dictionary<K, T> result;
 	std::ifstream file(filepath.c_str());
 
 	if (!file.is_open())
 	{
 		printf("Warning: Could not open %s. Starting with empty dictionary.\n", filepath.c_str());
-		return result;
+		return;
 	}
 
 	std::string line;
@@ -134,64 +287,67 @@ Dictionary<K, T> buildDictFromFile(const std::string &filepath, std::function<T(
 	}
 
 	file.close();
+}
+
+/// Loads objects from a CSV file and builds a Dictionary using a key extraction function.
+/// The builder and key function may be any callables.
+template <typename K, typename T, typename Builder, typename KeyFunc>
+Dictionary<K, T> buildDictFromFile(const std::string &filepath, Builder builder, KeyFunc keyFunc)
+{
+	Dictionary<K, T> result;
+	loadDictFromFile(filepath, result, builder, keyFunc);
 	return result;
 }
 
-/// Saves objects to a CSV file using a rowBuilder function to convert each object to CSV fields.
-template <typename T>
-void saveToFile(const std::string &filepath, const std::string &header, const Vector<T> &data, std::function<Vector<std::string>(const T &)> rowBuilder)
+/// Saves objects to a CSV file using a rowWriter function (any callable) that writes each object's fields.
+template <typename T, typename RowWriter>
+void saveToFile(const std::string &filepath, const std::string &header, const Vector<T> &data, RowWriter rowWriter)
 {
-	std::ofstream file(filepath.c_str());
+	CSVWriter writer(filepath);
 
-	if (!file.is_open())
+	if (!writer.isOpen())
 	{
 		printf("Error: Could not open %s for writing.\n", filepath.c_str());
 		return;
 	}
 
-	file << header << "\n";
+	writer.writeLine(header);
 
 	for (int i = 0; i < data.getSize(); i++)
 	{
-		Vector<std::string> fields = rowBuilder(data.get(i));
-		for (int j = 0; j < fields.getSize(); j++)
-		{
-			if (j > 0)
-				file << ",";
-			file << escapeCSVField(fields.get(j));
-		}
-		file << "\n";
+		rowWriter(writer, data[i]);
+		writer.endRow();
 	}
 
-	file.close();
+	if (!writer.close())
+	{
+		printf("Error: Could not write %s.\n", filepath.c_str());
+	}
 }
 
-/// Saves Dictionary values to a CSV file a rowBuilder function.
-template <typename K, typename V>
-void saveToFile(const std::string &filepath, const std::string &header, const Dictionary<K, V> &data, std::function<Vector<std::string>(const V &)> rowBuilder)
+/// Saves the values of a keyed table (a Dictionary, or any table with the same forEach) to a CSV file using a rowWriter function (any callable).
+template <typename K, typename V, typename Table, typename RowWriter>
+void saveToFile(const std::string &filepath, const std::string &header, const Table &data, RowWriter rowWriter)
 {
-	std::ofstream file(filepath.c_str());
+	CSVWriter writer(filepath);
 
-	if (!file.is_open())
+	if (!writer.isOpen())
 	{
 		printf("Error: Could not open %s for writing.\n", filepath.c_str());
 		return;
 	}
 
-	file << header << "\n";
+	writer.writeLine(header);
 
 	data.forEach([&](const K &key, const V &value)
 				 {
-		Vector<std::string> fields = rowBuilder(value);
-		for (int j = 0; j < fields.getSize(); j++)
-		{
-			if (j > 0)
-				file << ",";
-			file << escapeCSVField(fields.get(j));
-		}
-		file << "\n"; });
+		rowWriter(writer, value);
+		writer.endRow(); });
 
-	file.close();
+	if (!writer.close())
+	{
+		printf("Error: Could not write %s.\n", filepath.c_str());
+	}
 }
 
 #endif
@@ -5,8 +5,12 @@
 #include <string>
 #include <stdexcept>
 #include <functional>
+#include <type_traits>
+#include <utility>
 #include "Hash.h"
 #include "Vector.h"
+#include "View.h"
+#include "NodeAllocator.h"
 
 /*
  * Goh Jun Liang Bryan, Group 2, S10267146, P01
@@ -26,8 +30,65 @@ public:
     }
 };
 
-/// Hash table implementation of a dictionary (key-value map) with separate chaining.
+/// Forward iterator over the entries of a Dictionary, bucket by bucket.
+/// Each entry exposes .key and .item; the iterator is invalidated by any insert or remove.
 template <typename K, typename V>
+class DictionaryIterator
+{
+private:
+    DictionaryNode<K, V> *const *buckets;
+    int capacity;
+    int bucket;
+    const DictionaryNode<K, V> *node;
+
+    void skipEmptyBuckets()
+    {
+        while (node == nullptr && bucket + 1 < capacity)
+        {
+            bucket++;
+            node = buckets[bucket];
+        }
+    }
+
+public:
+    DictionaryIterator(DictionaryNode<K, V> *const *buckets, int capacity, int bucket)
+        : buckets(buckets), capacity(capacity), bucket(bucket),
+          node(bucket < capacity ? buckets[bucket] : nullptr)
+    {
+        if (bucket < capacity)
+            skipEmptyBuckets();
+    }
+
+    const DictionaryNode<K, V> &operator*() const { return *node; }
+    const DictionaryNode<K, V> *operator->() const { return node; }
+
+    DictionaryIterator &operator++()
+    {
+        node = node->next;
+        skipEmptyBuckets();
+        return *this;
+    }
+
+    bool operator==(const DictionaryIterator &other) const { return node == other.node; }
+    bool operator!=(const DictionaryIterator &other) const { return node != other.node; }
+};
+
+template <typename K, typename V>
+struct DictionaryKeyOf
+{
+    const K &operator()(const DictionaryNode<K, V> &entry) const { return entry.key; }
+};
+
+template <typename K, typename V>
+struct DictionaryItemOf
+{
+    const V &operator()(const DictionaryNode<K, V> &entry) const { return entry.item; }
+};
+
+/// Hash table implementation of a dictionary (key-value map) with separate chaining.
+/// Nodes come from the Allocator policy (see NodeAllocator.h): PoolAllocator by default, or
+/// ArenaAllocator for tables that are loaded once and never shrink.
+template <typename K, typename V, template <typename> class Allocator = PoolAllocator>
 class Dictionary
 {
 private:
@@ -35,6 +96,7 @@ private:
     int size;
     int capacity;
     K maxKey_;
+    Allocator<DictionaryNode<K, V>> nodes;
 
     int getIndex(const K &key) const
     {
@@ -55,32 +117,42 @@ private:
             items[i] = nullptr;
         }
 
-        size = 0;
-
-        // Rehash all entries from old table into new table
-        // Keys may map to different buckets due to new capacity
+        // Relink every node into its bucket in the new table
+        // Keys may map to different buckets due to new capacity; nodes themselves are not copied,
+        // so pointers returned by find() stay valid
         for (int i = 0; i < oldCapacity; i++)
         {
             DictionaryNode<K, V> *current = oldItems[i];
             while (current != nullptr)
             {
-                insert(current->key, current->item);
-                current = current->next;
+                DictionaryNode<K, V> *next = current->next;
+                int index = getIndex(current->key);
+                current->next = items[index];
+                items[index] = current;
+                current = next;
             }
         }
+        delete[] oldItems;
+    }
 
-        // Delete all nodes and the old table array
-        for (int i = 0; i < oldCapacity; i++)
+    // Destroys every node. Nodes with trivial destructors are not visited at all:
+    // the allocator just forgets them, so this is O(1) for tables such as Dictionary<int, int>.
+    void destroyAll()
+    {
+        if (!std::is_trivially_destructible<DictionaryNode<K, V>>::value)
         {
-            DictionaryNode<K, V> *current = oldItems[i];
-            while (current != nullptr)
+            for (int i = 0; i < capacity; i++)
             {
-                DictionaryNode<K, V> *temp = current;
-                current = current->next;
-                delete temp;
+                DictionaryNode<K, V> *current = items[i];
+                while (current != nullptr)
+                {
+                    DictionaryNode<K, V> *next = current->next;
+                    current->~DictionaryNode<K, V>();
+                    current = next;
+                }
             }
         }
-        delete[] oldItems;
+        nodes.reset();
     }
 
 public:
@@ -96,21 +168,12 @@ public:
 
     ~Dictionary()
     {
-        for (int i = 0; i < capacity; i++)
-        {
-            DictionaryNode<K, V> *current = items[i];
-            while (current != nullptr)
-            {
-                DictionaryNode<K, V> *temp = current;
-                current = current->next;
-                delete temp;
-            }
-        }
+        destroyAll();
         delete[] items;
     }
 
     Dictionary(const Dictionary &other)
-        : capacity(other.capacity), size(other.size), maxKey_(other.maxKey_)
+        : capacity(other.capacity), size(0), maxKey_(other.maxKey_)
     {
         items = new DictionaryNode<K, V> *[capacity];
         for (int i = 0; i < capacity; i++)
@@ -135,16 +198,7 @@ public:
         if (this != &other)
         {
             // Clean up existing data
-            for (int i = 0; i < capacity; i++)
-            {
-                DictionaryNode<K, V> *current = items[i];
-                while (current != nullptr)
-                {
-                    DictionaryNode<K, V> *temp = current;
-                    current = current->next;
-                    delete temp;
-                }
-            }
+            destroyAll();
             delete[] items;
 
             // Allocate new hash table matching other's capacity
@@ -197,7 +251,7 @@ public:
             current = current->next;
         }
 
-        DictionaryNode<K, V> *newNode = new DictionaryNode<K, V>(key, item);
+        DictionaryNode<K, V> *newNode = nodes.create(key, item);
         newNode->next = items[index];
         items[index] = newNode;
         size++;
@@ -232,7 +286,7 @@ public:
                 {
                     prev->next = current->next;
                 }
-                delete current;
+                nodes.destroy(current);
                 size--;
                 return true;
             }
@@ -243,6 +297,47 @@ public:
         return false;
     }
 
+    /*
+     * Finds the value stored for a key, so it can be read or updated in place.
+     * Parameters: key - the key to look up
+     * Returns: a pointer to the stored value, or nullptr if the key is not found.
+     *          The pointer stays valid until the key is removed.
+     */
+    V *find(const K &key)
+    {
+        DictionaryNode<K, V> *current = items[getIndex(key)];
+        while (current != nullptr)
+        {
+            if (current->key == key)
+            {
+                return &current->item;
+            }
+            current = current->next;
+        }
+        return nullptr;
+    }
+
+    const V *find(const K &key) const
+    {
+        return const_cast<Dictionary *>(this)->find(key);
+    }
+
+    /*
+     * Finds the value stored for a key, inserting a default-constructed value first if it is missing.
+     * Parameters: key - the key to look up
+     * Returns: a reference to the stored value
+     */
+    V &findOrInsert(const K &key)
+    {
+        V *existing = find(key);
+        if (existing == nullptr)
+        {
+            insert(key, V());
+            existing = find(key);
+        }
+        return *existing;
+    }
+
     /*
      * Gets the value associated with a key. Throws runtime_error if key not found.
      */
@@ -317,20 +412,15 @@ public:
 
     /*
      * Removes all entries from the dictionary, resetting it to empty state.
+     * Node memory is kept by the allocator and reused by later inserts.
      * Parameters: none
      * Returns: nothing
      */
     void clear()
     {
+        destroyAll();
         for (int i = 0; i < capacity; i++)
         {
-            DictionaryNode<K, V> *current = items[i];
-            while (current != nullptr)
-            {
-                DictionaryNode<K, V> *temp = current;
-                current = current->next;
-                delete temp;
-            }
             items[i] = nullptr;
         }
         size = 0;
@@ -359,13 +449,14 @@ public:
 
     /*
      * Extracts all values from the dictionary and applies a transformation function, returning results as a Vector.
-     * Parameters: transform - a function that converts each value from type V to type U
+     * Takes any callable, so the transformation is inlined into the loop.
+     * Parameters: transform - a function that converts each value from type V to another type
      * Returns: a Vector containing the transformed values
      */
-    template <typename U>
-    Vector<U> toVector(std::function<U(const V &)> transform) const
+    template <typename Transform>
+    auto toVector(Transform transform) const -> Vector<typename std::decay<decltype(transform(std::declval<const V &>()))>::type>
     {
-        Vector<U> result;
+        Vector<typename std::decay<decltype(transform(std::declval<const V &>()))>::type> result(size > 0 ? size : 1);
         for (int i = 0; i < capacity; i++)
         {
             DictionaryNode<K, V> *current = items[i];
@@ -378,13 +469,29 @@ public:
         return result;
     }
 
+    /*
+     * std::function version of toVector(transform), for callers that name the result type.
+     * Parameters: transform - a function that converts each value from type V to type U
+     * Returns: a Vector containing the transformed values
+     */
+    template <typename U>
+    Vector<U> toVector(std::function<U(const V &)> transform) const
+    {
+        Vector<U> result(size > 0 ? size : 1);
+        forEach([&](const K &, const V &value)
+                { result.append(transform(value)); });
+        return result;
+    }
+
     /*
      * Calls a function for each key-value pair in the dictionary.
+     * Takes any callable, so the function body is inlined into the loop.
      * Parameters: func - a function that takes a key and value and performs an action
      * Returns: nothing
      * Note: If no modifications are made to the dictionary, iteration order remains consistent
      */
-    void forEach(std::function<void(const K &, const V &)> func) const
+    template <typename Func>
+    void forEach(Func func) const
     {
         for (int i = 0; i < capacity; i++)
         {
@@ -397,6 +504,61 @@ public:
         }
     }
 
+    /*
+     * std::function version of forEach, for call sites that already hold one.
+     * Parameters: func - a function that takes a key and value and performs an action
+     * Returns: nothing
+     */
+    void forEach(std::function<void(const K &, const V &)> func) const
+    {
+        forEach<std::function<void(const K &, const V &)>>(func);
+    }
+
+    /*
+     * Iterators over the entries (each with .key and .item), for range-based for loops.
+     * Parameters: none
+     * Returns: an iterator to the first entry / past the last entry
+     */
+    DictionaryIterator<K, V> begin() const
+    {
+        return DictionaryIterator<K, V>(items, capacity, 0);
+    }
+
+    DictionaryIterator<K, V> end() const
+    {
+        return DictionaryIterator<K, V>(items, capacity, capacity);
+    }
+
+    /*
+     * Lazy view of the entries, which can be filtered, mapped, counted or sliced without copying.
+     * Parameters: none
+     * Returns: a View over the entries
+     */
+    View<DictionaryIterator<K, V>> entries() const
+    {
+        return View<DictionaryIterator<K, V>>(begin(), end());
+    }
+
+    /*
+     * Lazy view of the keys.
+     * Parameters: none
+     * Returns: a View yielding a const reference to each key
+     */
+    View<MapIterator<DictionaryIterator<K, V>, DictionaryKeyOf<K, V>>> keys() const
+    {
+        return entries().map(DictionaryKeyOf<K, V>());
+    }
+
+    /*
+     * Lazy view of the values, e.g. members.values().filter(isAdmin).slice(0, 10).
+     * Parameters: none
+     * Returns: a View yielding a const reference to each value
+     */
+    View<MapIterator<DictionaryIterator<K, V>, DictionaryItemOf<K, V>>> values() const
+    {
+        return entries().map(DictionaryItemOf<K, V>());
+    }
+
     /*
      * Returns the largest key currently stored in the dictionary.
      * Parameters: none
@@ -0,0 +1,204 @@
+#ifndef INDEXED_MIN_HEAP_H
+#define INDEXED_MIN_HEAP_H
+
+#include <stdexcept>
+#include "Vector.h"
+#include "Dictionary.h"
+
+/*
+ * Binary min-heap of keys ordered by an integer priority, with a key -> position index
+ * so any key can be re-prioritised or removed in O(log n), not only the minimum.
+ */
+template <typename K>
+class IndexedMinHeap
+{
+private:
+    struct Node
+    {
+        int priority;
+        K key;
+
+        Node() : priority(0), key() {}
+        Node(int priority, const K &key) : priority(priority), key(key) {}
+    };
+
+    Vector<Node> nodes;
+    Dictionary<K, int> positions;
+
+    void place(int index, const Node &node)
+    {
+        nodes[index] = node;
+        positions.insert(node.key, index);
+    }
+
+    void siftUp(int index)
+    {
+        Node node = nodes[index];
+        while (index > 0)
+        {
+            int parent = (index - 1) / 2;
+            if (nodes[parent].priority <= node.priority)
+                break;
+            place(index, nodes[parent]);
+            index = parent;
+        }
+        place(index, node);
+    }
+
+    void siftDown(int index)
+    {
+        Node node = nodes[index];
+        int size = nodes.getSize();
+        while (true)
+        {
+            int child = 2 * index + 1;
+            if (child >= size)
+                break;
+            if (child + 1 < size && nodes[child + 1].priority < nodes[child].priority)
+                child++;
+            if (node.priority <= nodes[child].priority)
+                break;
+            place(index, nodes[child]);
+            index = child;
+        }
+        place(index, node);
+    }
+
+    void removeAt(int index)
+    {
+        positions.remove(nodes[index].key);
+        int last = nodes.getSize() - 1;
+        if (index != last)
+        {
+            Node moved = nodes[last];
+            nodes.remove(last);
+            place(index, moved);
+            siftDown(index);
+            siftUp(positions.get(moved.key));
+        }
+        else
+        {
+            nodes.remove(last);
+        }
+    }
+
+public:
+    /*
+     * Adds a key, or changes its priority if it is already in the heap.
+     * Parameters: key - the key, priority - its priority (smaller comes first)
+     * Returns: nothing
+     */
+    void push(const K &key, int priority)
+    {
+        if (positions.exists(key))
+        {
+            int index = positions.get(key);
+            nodes[index].priority = priority;
+            siftDown(index);
+            siftUp(positions.get(key));
+            return;
+        }
+        nodes.append(Node(priority, key));
+        siftUp(nodes.getSize() - 1);
+    }
+
+    /*
+     * Removes a key from anywhere in the heap.
+     * Parameters: key - the key to remove
+     * Returns: true if the key was removed, false if it was not in the heap
+     */
+    bool remove(const K &key)
+    {
+        if (!positions.exists(key))
+            return false;
+        removeAt(positions.get(key));
+        return true;
+    }
+
+    bool contains(const K &key) const
+    {
+        return positions.exists(key);
+    }
+
+    /*
+     * Returns the key with the smallest priority.
+     * Parameters: none
+     * Returns: the key at the top, or throws runtime_error if the heap is empty
+     */
+    const K &topKey() const
+    {
+        if (nodes.isEmpty())
+            throw std::runtime_error("Heap is empty");
+        return nodes[0].key;
+    }
+
+    /*
+     * Returns the smallest priority in the heap.
+     * Parameters: none
+     * Returns: the priority at the top, or throws runtime_error if the heap is empty
+     */
+    int topPriority() const
+    {
+        if (nodes.isEmpty())
+            throw std::runtime_error("Heap is empty");
+        return nodes[0].priority;
+    }
+
+    /*
+     * Removes the key with the smallest priority.
+     * Parameters: none
+     * Returns: nothing
+     */
+    void pop()
+    {
+        if (!nodes.isEmpty())
+            removeAt(0);
+    }
+
+    /*
+     * Calls a function for every key with priority <= limit, in no particular order.
+     * Only those keys and their direct children are visited, since a node above the
+     * limit cannot have descendants below it.
+     * Parameters: limit - the largest priority to report,
+     *             func - a function taking a key and its priority
+     * Returns: nothing
+     */
+    template <typename Func>
+    void forEachAtMost(int limit, Func func) const
+    {
+        if (nodes.isEmpty() || nodes[0].priority > limit)
+            return;
+
+        Vector<int> pending;
+        pending.append(0);
+        while (!pending.isEmpty())
+        {
+            int index = pending[pending.getSize() - 1];
+            pending.remove(pending.getSize() - 1);
+            func(nodes[index].key, nodes[index].priority);
+            for (int child = 2 * index + 1; child <= 2 * index + 2 && child < nodes.getSize(); child++)
+            {
+                if (nodes[child].priority <= limit)
+                    pending.append(child);
+            }
+        }
+    }
+
+    int getSize() const
+    {
+        return nodes.getSize();
+    }
+
+    bool isEmpty() const
+    {
+        return nodes.isEmpty();
+    }
+
+    void clear()
+    {
+        nodes.clear();
+        positions.clear();
+    }
+};
+
+#endif
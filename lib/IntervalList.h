@@ -0,0 +1,150 @@
+#ifndef INTERVAL_LIST_H
+#define INTERVAL_LIST_H
+
+#include "Vector.h"
+#include "Search.h"
+
+/// A half-open interval [start, end) tagged with the key of the record it came from
+template <typename K>
+struct Interval
+{
+    int start;
+    int end;
+    K key;
+
+    Interval() : start(0), end(0), key() {}
+    Interval(int start, int end, const K &key) : start(start), end(end), key(key) {}
+};
+
+/*
+ * Non-overlapping half-open intervals sorted by start, e.g. the successive loans of one item.
+ * Because the intervals never overlap, their ends are sorted too, so both point and range
+ * queries start with a binary search and then touch only the intervals that match.
+ * Precondition: intervals must not overlap, i.e. each one ends no later than the next one
+ * starts; otherwise the end order breaks and queries can miss intervals.
+ * Adding in start order appends in O(1); an out-of-order add shifts the tail, so bulk loads
+ * should add intervals sorted by start.
+ */
+template <typename K>
+class IntervalList
+{
+private:
+    Vector<Interval<K>> intervals;
+
+    // Position of the first interval with start >= time
+    int firstStartingAt(int time) const
+    {
+        return partitionPoint(intervals.getSize(), [&](int index)
+                              { return intervals[index].start < time; });
+    }
+
+    // Position of the first interval with end > time
+    int firstEndingAfter(int time) const
+    {
+        return partitionPoint(intervals.getSize(), [&](int index)
+                              { return intervals[index].end <= time; });
+    }
+
+public:
+    /*
+     * Adds an interval, appending when it starts after every existing one.
+     * Parameters: start, end - the interval bounds, key - the record it belongs to
+     * Returns: nothing
+     */
+    void add(int start, int end, const K &key)
+    {
+        Interval<K> interval(start, end, key);
+        if (intervals.isEmpty() || intervals[intervals.getSize() - 1].start <= start)
+        {
+            intervals.append(interval);
+            return;
+        }
+        intervals.insert(firstStartingAt(start), interval);
+    }
+
+    /*
+     * Changes the end of an interval, e.g. when an open loan is returned.
+     * Parameters: start, key - identify the interval, end - the new end
+     * Returns: true if the interval was found, false otherwise
+     */
+    bool setEnd(int start, const K &key, int end)
+    {
+        for (int i = firstStartingAt(start); i < intervals.getSize() && intervals[i].start == start; i++)
+        {
+            if (intervals[i].key == key)
+            {
+                intervals[i].end = end;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Finds the intervals overlapping a time range.
+     * Parameters: from, to - the half-open range [from, to),
+     *             first, last - receive the positions [first, last) of the overlapping intervals
+     * Returns: nothing
+     */
+    void findOverlapping(int from, int to, int &first, int &last) const
+    {
+        first = firstEndingAfter(from);
+        last = firstStartingAt(to);
+        if (last < first)
+        {
+            last = first;
+        }
+    }
+
+    /*
+     * Finds the interval containing a point in time.
+     * Parameters: time - the time to look up
+     * Returns: the position of the interval with start <= time < end, or -1 if none
+     */
+    int findAt(int time) const
+    {
+        int index = firstEndingAfter(time);
+        return (index < intervals.getSize() && intervals[index].start <= time) ? index : -1;
+    }
+
+    /*
+     * Measures how much of a time range is covered by intervals.
+     * Parameters: from, to - the half-open range [from, to)
+     * Returns: the total covered length within the range
+     */
+    long long coveredLength(int from, int to) const
+    {
+        int first, last;
+        findOverlapping(from, to, first, last);
+        long long covered = 0;
+        for (int i = first; i < last; i++)
+        {
+            int start = intervals[i].start > from ? intervals[i].start : from;
+            int end = intervals[i].end < to ? intervals[i].end : to;
+            covered += end - start;
+        }
+        return covered;
+    }
+
+    const Interval<K> &at(int index) const
+    {
+        return intervals[index];
+    }
+
+    int getSize() const
+    {
+        return intervals.getSize();
+    }
+
+    bool isEmpty() const
+    {
+        return intervals.isEmpty();
+    }
+
+    void clear()
+    {
+        intervals.clear();
+    }
+};
+
+#endif
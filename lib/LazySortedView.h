@@ -0,0 +1,116 @@
+#ifndef LAZY_SORTED_VIEW_H
+#define LAZY_SORTED_VIEW_H
+
+#include <stdexcept>
+#include <functional>
+#include "Vector.h"
+#include "Sort.h"
+
+/*
+ * A collection that is sorted only as far as it has been read, for paginated screens where most
+ * users never leave the first page. Uses incremental quicksort: reading position i partitions
+ * just enough of the unsorted tail to fix the elements up to i, and remembers the pivot
+ * positions it found so later pages reuse that work. Reading the first k elements costs
+ * O(n + k log k) expected, and reading everything costs no more than a full quicksort.
+ * Elements comparing equal may appear in any order.
+ * The comparator type is a template parameter, as in the Sort functions, so partitioning calls it
+ * directly; it defaults to std::function for callers that pass a plain function or lambda.
+ */
+template <typename T, typename Compare = std::function<int(const T &, const T &)>>
+class LazySortedView
+{
+private:
+    Vector<T> items;
+    Compare compare;
+    int sortedCount;    // items[0, sortedCount) are in their final positions
+    Vector<int> bounds; // pivot positions, decreasing; every item before a bound is <= every item after it
+
+    void sortThrough(int end)
+    {
+        T *data = items.data();
+        while (sortedCount < end)
+        {
+            while (!bounds.isEmpty() && bounds[bounds.getSize() - 1] <= sortedCount)
+            {
+                bounds.remove(bounds.getSize() - 1);
+            }
+            int top = bounds.isEmpty() ? items.getSize() : bounds[bounds.getSize() - 1];
+
+            if (top - sortedCount <= Sort::INSERTION_SORT_THRESHOLD)
+            {
+                Sort::insertionSort(data, sortedCount, top, compare);
+                sortedCount = top;
+                continue;
+            }
+
+            int lt, gt;
+            Sort::partition(data, sortedCount, top, compare, lt, gt);
+            if (lt == sortedCount)
+            {
+                // The smallest remaining items were the pivot's equals, so they are final
+                sortedCount = gt;
+            }
+            else
+            {
+                if (gt < top)
+                    bounds.append(gt);
+                bounds.append(lt);
+            }
+        }
+    }
+
+public:
+    /*
+     * Creates a view over a set of items without sorting them yet.
+     * Parameters: items - the items to present in order,
+     *             compare - comparison function returning negative if a < b, 0 if a == b, positive if a > b
+     */
+    LazySortedView(const Vector<T> &items, Compare compare)
+        : items(items), compare(compare), sortedCount(0)
+    {
+    }
+
+    LazySortedView() : compare(), sortedCount(0) {}
+
+    /*
+     * Retrieves the item at a position in sorted order, sorting further if needed.
+     * Parameters: index - the 0-based position
+     * Returns: the item, or throws out_of_range if index is invalid
+     */
+    const T &get(int index)
+    {
+        if (index < 0 || index >= items.getSize())
+        {
+            throw std::out_of_range("Index out of range");
+        }
+        sortThrough(index + 1);
+        return items[index];
+    }
+
+    const T &operator[](int index)
+    {
+        return get(index);
+    }
+
+    /*
+     * Sorts enough of the items that a range can be read in order.
+     * Parameters: end - one past the last position that will be read
+     * Returns: nothing
+     */
+    void prepare(int end)
+    {
+        sortThrough(end < items.getSize() ? end : items.getSize());
+    }
+
+    int getSize() const
+    {
+        return items.getSize();
+    }
+
+    bool isEmpty() const
+    {
+        return items.isEmpty();
+    }
+};
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef NODE_ALLOCATOR_H
+#define NODE_ALLOCATOR_H
+
+#include <new>
+#include <utility>
+#include "Vector.h"
+
+/*
+ * Allocators for the fixed-size nodes of Dictionary and Set. Nodes are carved out of large
+ * blocks instead of being allocated one by one, so loading a table takes a handful of
+ * allocations, neighbouring nodes share cache lines, and clearing or destroying a table
+ * releases whole blocks instead of walking and freeing every node.
+ *
+ * PoolAllocator, the default, puts removed nodes on a free list and reuses them.
+ * ArenaAllocator only ever bumps forward and gets its memory back when the table is cleared,
+ * which suits tables that are loaded once and afterwards only grow.
+ */
+
+/// Block storage shared by the node allocators: hands out fresh slots in order, block by block.
+/// Blocks double in size up to MAX_BLOCK_SIZE slots, and are kept across reset() for reuse.
+template <typename T>
+class NodeBlocks
+{
+protected:
+    union Slot
+    {
+        Slot *nextFree;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static const int FIRST_BLOCK_SIZE = 32;
+    static const int MAX_BLOCK_SIZE = 8192;
+
+    Vector<Slot *> blocks;
+    Vector<int> blockSizes;
+    int currentBlock; // block the next fresh slot comes from
+    int used;         // slots of the current block already handed out
+
+    Slot *nextFreshSlot()
+    {
+        if (currentBlock < blocks.getSize() && used == blockSizes[currentBlock])
+        {
+            currentBlock++;
+            used = 0;
+        }
+        if (currentBlock == blocks.getSize())
+        {
+            int blockSize = blocks.isEmpty() ? FIRST_BLOCK_SIZE : blockSizes[blocks.getSize() - 1] * 2;
+            if (blockSize > MAX_BLOCK_SIZE)
+                blockSize = MAX_BLOCK_SIZE;
+            blocks.append(new Slot[blockSize]);
+            blockSizes.append(blockSize);
+        }
+        return &blocks[currentBlock][used++];
+    }
+
+    void rewind()
+    {
+        currentBlock = 0;
+        used = 0;
+    }
+
+public:
+    NodeBlocks() : blocks(4), blockSizes(4), currentBlock(0), used(0) {}
+
+    ~NodeBlocks()
+    {
+        for (int i = 0; i < blocks.getSize(); i++)
+        {
+            delete[] blocks[i];
+        }
+    }
+
+    // Each table owns its nodes, so allocators are never shared or copied
+    NodeBlocks(const NodeBlocks &) = delete;
+    NodeBlocks &operator=(const NodeBlocks &) = delete;
+
+    /*
+     * Returns the number of blocks allocated so far.
+     * Parameters: none
+     * Returns: the block count
+     */
+    int getBlockCount() const
+    {
+        return blocks.getSize();
+    }
+};
+
+/// Fixed-size node pool: removed nodes go on a free list and are handed out again first.
+template <typename T>
+class PoolAllocator : public NodeBlocks<T>
+{
+private:
+    typedef typename NodeBlocks<T>::Slot Slot;
+
+    Slot *freeList;
+
+public:
+    PoolAllocator() : freeList(nullptr) {}
+
+    /*
+     * Constructs a node in a free slot.
+     * Parameters: args - the node's constructor arguments
+     * Returns: a pointer to the new node
+     */
+    template <typename... Args>
+    T *create(Args &&...args)
+    {
+        Slot *slot;
+        if (freeList != nullptr)
+        {
+            slot = freeList;
+            freeList = freeList->nextFree;
+        }
+        else
+        {
+            slot = this->nextFreshSlot();
+        }
+        return new (slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    /*
+     * Destroys a node and puts its slot on the free list.
+     * Parameters: node - a node returned by create()
+     * Returns: nothing
+     */
+    void destroy(T *node)
+    {
+        node->~T();
+        Slot *slot = reinterpret_cast<Slot *>(node);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+
+    /*
+     * Forgets every node at once, keeping the blocks for reuse. Destructors are not run,
+     * so nodes that need one must be destroyed first.
+     * Parameters: none
+     * Returns: nothing
+     */
+    void reset()
+    {
+        freeList = nullptr;
+        this->rewind();
+    }
+};
+
+/// Bump allocator: nodes are placed one after another and slots are only reclaimed by reset().
+/// Removing a node runs its destructor but leaves the slot unused until the table is cleared.
+template <typename T>
+class ArenaAllocator : public NodeBlocks<T>
+{
+public:
+    /*
+     * Constructs a node in the next slot.
+     * Parameters: args - the node's constructor arguments
+     * Returns: a pointer to the new node
+     */
+    template <typename... Args>
+    T *create(Args &&...args)
+    {
+        return new (this->nextFreshSlot()->storage) T(std::forward<Args>(args)...);
+    }
+
+    /*
+     * Destroys a node. Its slot is not reused until reset().
+     * Parameters: node - a node returned by create()
+     * Returns: nothing
+     */
+    void destroy(T *node)
+    {
+        node->~T();
+    }
+
+    /*
+     * Forgets every node at once, keeping the blocks for reuse. Destructors are not run,
+     * so nodes that need one must be destroyed first.
+     * Parameters: none
+     * Returns: nothing
+     */
+    void reset()
+    {
+        this->rewind();
+    }
+};
+
+#endif
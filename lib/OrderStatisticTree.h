@@ -0,0 +1,269 @@
+#ifndef ORDER_STATISTIC_TREE_H
+#define ORDER_STATISTIC_TREE_H
+
+#include <stdexcept>
+#include <functional>
+
+/*
+ * Ordered set with rank queries, implemented as a treap (a binary search tree kept balanced
+ * by random heap priorities). Every node stores the size of its subtree, so insert, remove,
+ * the k-th smallest element and the rank of an element are all O(log n) expected.
+ * Elements are ordered by a comparator returning negative, 0 or positive; elements comparing
+ * equal are treated as the same element.
+ * The comparator type is a template parameter so a function object is called directly and can be
+ * inlined; it defaults to std::function for callers that pass a plain function or lambda.
+ */
+template <typename T, typename Compare = std::function<int(const T &, const T &)>>
+class OrderStatisticTree
+{
+private:
+    struct Node
+    {
+        T value;
+        unsigned int priority;
+        int size;
+        Node *left;
+        Node *right;
+
+        Node(const T &value, unsigned int priority)
+            : value(value), priority(priority), size(1), left(nullptr), right(nullptr) {}
+    };
+
+    Node *root;
+    Compare compare;
+    unsigned int seed;
+
+    unsigned int nextPriority()
+    {
+        // xorshift32
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    static int sizeOf(const Node *node)
+    {
+        return node == nullptr ? 0 : node->size;
+    }
+
+    static void update(Node *node)
+    {
+        node->size = 1 + sizeOf(node->left) + sizeOf(node->right);
+    }
+
+    // Splits a subtree into the elements ordered before value and the rest
+    void split(Node *node, const T &value, Node *&less, Node *&rest)
+    {
+        if (node == nullptr)
+        {
+            less = rest = nullptr;
+            return;
+        }
+        if (compare(node->value, value) < 0)
+        {
+            split(node->right, value, node->right, rest);
+            less = node;
+        }
+        else
+        {
+            split(node->left, value, less, node->left);
+            rest = node;
+        }
+        update(node);
+    }
+
+    // Joins two subtrees where every element of left orders before every element of right
+    static Node *merge(Node *left, Node *right)
+    {
+        if (left == nullptr)
+            return right;
+        if (right == nullptr)
+            return left;
+        if (left->priority > right->priority)
+        {
+            left->right = merge(left->right, right);
+            update(left);
+            return left;
+        }
+        right->left = merge(left, right->left);
+        update(right);
+        return right;
+    }
+
+    bool removeFrom(Node *&node, const T &value)
+    {
+        if (node == nullptr)
+            return false;
+
+        int order = compare(value, node->value);
+        if (order == 0)
+        {
+            Node *removed = node;
+            node = merge(node->left, node->right);
+            delete removed;
+            return true;
+        }
+
+        bool removed = removeFrom(order < 0 ? node->left : node->right, value);
+        if (removed)
+        {
+            update(node);
+        }
+        return removed;
+    }
+
+    static Node *copyNodes(const Node *node)
+    {
+        if (node == nullptr)
+            return nullptr;
+        Node *copy = new Node(node->value, node->priority);
+        copy->size = node->size;
+        copy->left = copyNodes(node->left);
+        copy->right = copyNodes(node->right);
+        return copy;
+    }
+
+    static void deleteNodes(Node *node)
+    {
+        if (node == nullptr)
+            return;
+        deleteNodes(node->left);
+        deleteNodes(node->right);
+        delete node;
+    }
+
+public:
+    OrderStatisticTree(Compare compare)
+        : root(nullptr), compare(compare), seed(2463534242u) {}
+
+    ~OrderStatisticTree()
+    {
+        deleteNodes(root);
+    }
+
+    OrderStatisticTree(const OrderStatisticTree &other)
+        : root(copyNodes(other.root)), compare(other.compare), seed(other.seed) {}
+
+    OrderStatisticTree &operator=(const OrderStatisticTree &other)
+    {
+        if (this != &other)
+        {
+            deleteNodes(root);
+            root = copyNodes(other.root);
+            compare = other.compare;
+            seed = other.seed;
+        }
+        return *this;
+    }
+
+    /*
+     * Inserts an element, unless an equal element is already present.
+     * Parameters: value - the element to insert
+     * Returns: true if the element was inserted, false if it was already present
+     */
+    bool insert(const T &value)
+    {
+        Node *less, *rest;
+        split(root, value, less, rest);
+
+        // The smallest element of rest is the only one that can compare equal
+        Node *first = rest;
+        while (first != nullptr && first->left != nullptr)
+        {
+            first = first->left;
+        }
+        if (first != nullptr && compare(first->value, value) == 0)
+        {
+            root = merge(less, rest);
+            return false;
+        }
+
+        root = merge(merge(less, new Node(value, nextPriority())), rest);
+        return true;
+    }
+
+    /*
+     * Removes an element.
+     * Parameters: value - the element to remove
+     * Returns: true if the element was removed, false if it was not present
+     */
+    bool remove(const T &value)
+    {
+        return removeFrom(root, value);
+    }
+
+    /*
+     * Retrieves the element at a position in sorted order.
+     * Parameters: k - the 0-based rank of the element
+     * Returns: the k-th smallest element, or throws out_of_range if k is invalid
+     */
+    const T &kth(int k) const
+    {
+        if (k < 0 || k >= sizeOf(root))
+        {
+            throw std::out_of_range("Rank out of range");
+        }
+
+        const Node *node = root;
+        while (true)
+        {
+            int leftSize = sizeOf(node->left);
+            if (k < leftSize)
+            {
+                node = node->left;
+            }
+            else if (k == leftSize)
+            {
+                return node->value;
+            }
+            else
+            {
+                k -= leftSize + 1;
+                node = node->right;
+            }
+        }
+    }
+
+    /*
+     * Counts the elements ordered before a value.
+     * Parameters: value - the value to rank (need not be present)
+     * Returns: the number of elements strictly less than value
+     */
+    int rank(const T &value) const
+    {
+        int count = 0;
+        const Node *node = root;
+        while (node != nullptr)
+        {
+            if (compare(node->value, value) < 0)
+            {
+                count += sizeOf(node->left) + 1;
+                node = node->right;
+            }
+            else
+            {
+                node = node->left;
+            }
+        }
+        return count;
+    }
+
+    int getSize() const
+    {
+        return sizeOf(root);
+    }
+
+    bool isEmpty() const
+    {
+        return root == nullptr;
+    }
+
+    void clear()
+    {
+        deleteNodes(root);
+        root = nullptr;
+    }
+};
+
+#endif
@@ -1,16 +1,248 @@
 #ifndef SEARCH_H
 #define SEARCH_H
 
-#include <functional>
+#include "Vector.h"
+
+/*
+ * Binary search helpers. All of them are templates taking the comparison or predicate as any
+ * callable (usually a lambda), so each probe is an inlined call rather than an indirect call
+ * through std::function.
+ */
 
 /**
  * Binary search on a range [0, size) with a custom comparison function
  * @param size The size of the range to search [0, size)
  * @param compare Custom comparison function that takes an index and returns:
- *                0 if match found, -1 to search right, 1 to search left
+ *                0 if match found, negative to search right, positive to search left
  * @param returnNotFound If true, returns -1 when not found; otherwise returns insertion point
  * @return The index of the match if found, or -1/insertion point depending on returnNotFound
  */
-int binarySearch(int size, std::function<int(int)> compare, bool returnNotFound = true);
+template <typename Compare>
+int binarySearch(int size, Compare compare, bool returnNotFound = true)
+{
+    int left = 0, right = size;
+
+    while (left < right)
+    {
+        int mid = left + (right - left) / 2;
+        int order = compare(mid);
+
+        if (order == 0)
+        {
+            return mid;
+        }
+        else if (order < 0)
+        {
+            left = mid + 1;
+        }
+        else
+        {
+            right = mid;
+        }
+    }
+
+    return returnNotFound ? -1 : left;
+}
+
+/**
+ * Finds the end of the leading part of a range [0, size) for which a predicate holds
+ * The predicate must be true for some prefix of the range and false for the rest
+ * @param size The size of the range to search [0, size)
+ * @param isBefore Function taking an index and returning true while still before the target
+ * @return The first index for which isBefore is false (size if there is none)
+ */
+template <typename Predicate>
+int partitionPoint(int size, Predicate isBefore)
+{
+    int left = 0, right = size;
+    while (left < right)
+    {
+        int mid = left + (right - left) / 2;
+        if (isBefore(mid))
+            left = mid + 1;
+        else
+            right = mid;
+    }
+    return left;
+}
+
+/**
+ * Finds the first element of a sorted array that is not less than a key
+ * @param data The sorted elements
+ * @param size Number of elements
+ * @param key The key to search for
+ * @param compare Function comparing an element with the key, returning negative, 0 or positive
+ * @return The position of the first element >= key (size if there is none)
+ */
+template <typename T, typename Key, typename Compare>
+int lowerBound(const T *data, int size, const Key &key, Compare compare)
+{
+    return partitionPoint(size, [&](int index)
+                          { return compare(data[index], key) < 0; });
+}
+
+/**
+ * Finds the first element of a sorted array that is greater than a key
+ * @param data The sorted elements
+ * @param size Number of elements
+ * @param key The key to search for
+ * @param compare Function comparing an element with the key, returning negative, 0 or positive
+ * @return The position of the first element > key (size if there is none)
+ */
+template <typename T, typename Key, typename Compare>
+int upperBound(const T *data, int size, const Key &key, Compare compare)
+{
+    return partitionPoint(size, [&](int index)
+                          { return compare(data[index], key) <= 0; });
+}
+
+/**
+ * Branchless lower bound: the loop always runs log2(size) times and the only decision is a
+ * select the compiler can turn into a conditional move, so there are no mispredicted branches.
+ * Best for small or hot arrays of cheap-to-compare elements.
+ * @param data The sorted elements
+ * @param size Number of elements
+ * @param key The key to search for
+ * @param compare Function comparing an element with the key, returning negative, 0 or positive
+ * @return The position of the first element >= key (size if there is none)
+ */
+template <typename T, typename Key, typename Compare>
+int branchlessLowerBound(const T *data, int size, const Key &key, Compare compare)
+{
+    if (size == 0)
+        return 0;
+
+    const T *base = data;
+    int remaining = size;
+    while (remaining > 1)
+    {
+        int half = remaining / 2;
+        base = compare(base[half - 1], key) < 0 ? base + half : base;
+        remaining -= half;
+    }
+    return (int)(base - data) + (compare(*base, key) < 0 ? 1 : 0);
+}
+
+/**
+ * Branchless upper bound; see branchlessLowerBound
+ * @param data The sorted elements
+ * @param size Number of elements
+ * @param key The key to search for
+ * @param compare Function comparing an element with the key, returning negative, 0 or positive
+ * @return The position of the first element > key (size if there is none)
+ */
+template <typename T, typename Key, typename Compare>
+int branchlessUpperBound(const T *data, int size, const Key &key, Compare compare)
+{
+    if (size == 0)
+        return 0;
+
+    const T *base = data;
+    int remaining = size;
+    while (remaining > 1)
+    {
+        int half = remaining / 2;
+        base = compare(base[half - 1], key) <= 0 ? base + half : base;
+        remaining -= half;
+    }
+    return (int)(base - data) + (compare(*base, key) <= 0 ? 1 : 0);
+}
+
+/*
+ * A sorted array stored in Eytzinger (breadth-first heap) order for repeated searching.
+ * The first levels of the implicit search tree sit next to each other in memory, so a search
+ * touches far fewer cache lines than a binary search over the sorted order, and the next
+ * probe's address depends only on one comparison. Meant for static arrays that are searched
+ * often; it has to be rebuilt if the data changes. Results are reported as positions in the
+ * original sorted order.
+ */
+template <typename T>
+class EytzingerArray
+{
+private:
+    Vector<T> tree;         // tree[1..size]; the children of k are 2k and 2k + 1
+    Vector<int> positions;  // positions[k] = sorted position of tree[k]
+    int size;
+
+    int fill(const Vector<T> &sorted, int next, int k)
+    {
+        if (k <= size)
+        {
+            next = fill(sorted, next, 2 * k);
+            tree[k] = sorted[next];
+            positions[k] = next;
+            next = fill(sorted, next + 1, 2 * k + 1);
+        }
+        return next;
+    }
+
+    // Undoes the trailing right turns and the last left turn of a search path,
+    // leaving the last node where the search went left (0 if it never did)
+    static int lastLeftTurn(int k)
+    {
+        while (k & 1)
+        {
+            k >>= 1;
+        }
+        return k >> 1;
+    }
+
+public:
+    EytzingerArray() : size(0) {}
+
+    /*
+     * Builds the layout from sorted data.
+     * Parameters: sorted - the elements in ascending order
+     */
+    EytzingerArray(const Vector<T> &sorted)
+        : tree(sorted.getSize() + 1), positions(sorted.getSize() + 1), size(sorted.getSize())
+    {
+        for (int k = 0; k <= size; k++)
+        {
+            tree.append(T());
+            positions.append(size);
+        }
+        fill(sorted, 0, 1);
+    }
+
+    /*
+     * Finds the first element that is not less than a key.
+     * Parameters: key - the key to search for,
+     *             compare - function comparing an element with the key, returning negative, 0 or positive
+     * Returns: the sorted position of the first element >= key (getSize() if there is none)
+     */
+    template <typename Key, typename Compare>
+    int lowerBound(const Key &key, Compare compare) const
+    {
+        int k = 1;
+        while (k <= size)
+        {
+            k = 2 * k + (compare(tree[k], key) < 0 ? 1 : 0);
+        }
+        return positions[lastLeftTurn(k)];
+    }
+
+    /*
+     * Finds the first element that is greater than a key.
+     * Parameters: key - the key to search for,
+     *             compare - function comparing an element with the key, returning negative, 0 or positive
+     * Returns: the sorted position of the first element > key (getSize() if there is none)
+     */
+    template <typename Key, typename Compare>
+    int upperBound(const Key &key, Compare compare) const
+    {
+        int k = 1;
+        while (k <= size)
+        {
+            k = 2 * k + (compare(tree[k], key) <= 0 ? 1 : 0);
+        }
+        return positions[lastLeftTurn(k)];
+    }
+
+    int getSize() const
+    {
+        return size;
+    }
+};
 
 #endif
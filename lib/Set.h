@@ -3,7 +3,9 @@
 
 #include <string>
 #include <stdexcept>
+#include <type_traits>
 #include "Hash.h"
+#include "NodeAllocator.h"
 
 /*
  * Goh Jun Liang Bryan, Group 2, S10267146, P01
@@ -23,13 +25,15 @@ public:
 };
 
 /// Hash table implementation of a set storing unique values with separate chaining.
-template <typename T>
+/// Nodes come from the Allocator policy (see NodeAllocator.h), as in Dictionary.
+template <typename T, template <typename> class Allocator = PoolAllocator>
 class Set
 {
 private:
     SetNode<T> **items;
     int size;
     int capacity;
+    Allocator<SetNode<T>> nodes;
 
     int getIndex(const T &value) const
     {
@@ -49,29 +53,39 @@ private:
             items[i] = nullptr;
         }
 
-        size = 0;
-
+        // Relink every node into its bucket in the new table instead of copying it
         for (int i = 0; i < oldCapacity; i++)
         {
             SetNode<T> *current = oldItems[i];
             while (current != nullptr)
             {
-                insert(current->value);
-                current = current->next;
+                SetNode<T> *next = current->next;
+                int index = getIndex(current->value);
+                current->next = items[index];
+                items[index] = current;
+                current = next;
             }
         }
+        delete[] oldItems;
+    }
 
-        for (int i = 0; i < oldCapacity; i++)
+    // Destroys every node; O(1) when values have trivial destructors, as in Dictionary
+    void destroyAll()
+    {
+        if (!std::is_trivially_destructible<SetNode<T>>::value)
         {
-            SetNode<T> *current = oldItems[i];
-            while (current != nullptr)
+            for (int i = 0; i < capacity; i++)
             {
-                SetNode<T> *temp = current;
-                current = current->next;
-                delete temp;
+                SetNode<T> *current = items[i];
+                while (current != nullptr)
+                {
+                    SetNode<T> *next = current->next;
+                    current->~SetNode<T>();
+                    current = next;
+                }
             }
         }
-        delete[] oldItems;
+        nodes.reset();
     }
 
 public:
@@ -87,21 +101,12 @@ public:
 
     ~Set()
     {
-        for (int i = 0; i < capacity; i++)
-        {
-            SetNode<T> *current = items[i];
-            while (current != nullptr)
-            {
-                SetNode<T> *temp = current;
-                current = current->next;
-                delete temp;
-            }
-        }
+        destroyAll();
         delete[] items;
     }
 
     Set(const Set &other)
-        : capacity(other.capacity), size(other.size)
+        : capacity(other.capacity), size(0)
     {
         items = new SetNode<T> *[capacity];
         for (int i = 0; i < capacity; i++)
@@ -124,16 +129,7 @@ public:
     {
         if (this != &other)
         {
-            for (int i = 0; i < capacity; i++)
-            {
-                SetNode<T> *current = items[i];
-                while (current != nullptr)
-                {
-                    SetNode<T> *temp = current;
-                    current = current->next;
-                    delete temp;
-                }
-            }
+            destroyAll();
             delete[] items;
 
             capacity = other.capacity;
@@ -181,7 +177,7 @@ public:
             current = current->next;
         }
 
-        SetNode<T> *newNode = new SetNode<T>(value);
+        SetNode<T> *newNode = nodes.create(value);
         newNode->next = items[index];
         items[index] = newNode;
         size++;
@@ -211,7 +207,7 @@ public:
                 {
                     prev->next = current->next;
                 }
-                delete current;
+                nodes.destroy(current);
                 size--;
                 return true;
             }
@@ -276,20 +272,15 @@ public:
 
     /*
      * Removes all values from the set, leaving it empty.
+     * Node memory is kept by the allocator and reused by later inserts.
      * Parameters: none
      * Returns: nothing
      */
     void clear()
     {
+        destroyAll();
         for (int i = 0; i < capacity; i++)
         {
-            SetNode<T> *current = items[i];
-            while (current != nullptr)
-            {
-                SetNode<T> *temp = current;
-                current = current->next;
-                delete temp;
-            }
             items[i] = nullptr;
         }
         size = 0;
@@ -0,0 +1,291 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <string_view>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "Vector.h"
+#include "AtomicFile.h"
+
+/*
+ * Binary snapshot format used to start the application without parsing CSV text.
+ *
+ * Layout (all values little-endian, every block padded to a 4-byte boundary so the
+ * payload can be used in place, e.g. from a memory-mapped file):
+ *   header  : magic "NPTS", format version, payload size, FNV-1a checksum of payload
+ *   payload : sequence of sections, each a row count followed by fixed-width int32 columns
+ *             and string columns (an int32 offset table followed by a byte heap)
+ */
+const char SNAPSHOT_MAGIC[4] = {'N', 'P', 'T', 'S'};
+
+/**
+ * Computes the 32-bit FNV-1a checksum of a block of bytes
+ * @param data Pointer to the first byte
+ * @param length Number of bytes to hash
+ * @return The checksum value
+ */
+inline uint32_t snapshotChecksum(const char *data, size_t length)
+{
+    uint32_t checksum = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        checksum ^= (unsigned char)data[i];
+        checksum *= 16777619u;
+    }
+    return checksum;
+}
+
+/**
+ * Accumulates snapshot sections in memory and writes them out with a single write call
+ */
+class SnapshotWriter
+{
+private:
+    std::string payload;
+
+    void pad()
+    {
+        while (payload.size() % 4 != 0)
+        {
+            payload += '\0';
+        }
+    }
+
+public:
+    /**
+     * Appends a single int32 value (section tags, row counts)
+     * @param value The value to append
+     */
+    void writeInt(int32_t value)
+    {
+        payload.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    /**
+     * Appends a single int64 value (file sizes, timestamps)
+     * @param value The value to append
+     */
+    void writeInt64(int64_t value)
+    {
+        payload.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    /**
+     * Appends one fixed-width int32 column extracted from a set of rows
+     * @param rows The rows to read the column from (a Vector, or any View such as Dictionary::values())
+     * @param getValue Function extracting the integer field from a row
+     */
+    template <typename Rows, typename Getter>
+    void writeIntColumn(const Rows &rows, Getter getValue)
+    {
+        for (const auto &row : rows)
+        {
+            writeInt((int32_t)getValue(row));
+        }
+    }
+
+    /**
+     * Appends one string column: an offset table of (count + 1) entries followed by the string heap
+     * @param rows The rows to read the column from (a Vector, or any View such as Dictionary::values())
+     * @param getValue Function extracting the string field from a row
+     */
+    template <typename Rows, typename Getter>
+    void writeStringColumn(const Rows &rows, Getter getValue)
+    {
+        int32_t offset = 0;
+        writeInt(offset);
+        for (const auto &row : rows)
+        {
+            offset += (int32_t)getValue(row).size();
+            writeInt(offset);
+        }
+        for (const auto &row : rows)
+        {
+            payload += getValue(row);
+        }
+        pad();
+    }
+
+    /**
+     * Writes the header and accumulated payload to a file, replacing any previous snapshot atomically
+     * @param filepath Path of the snapshot file to write
+     * @param version Format version stored in the header
+     * @return true if the whole snapshot was written, false otherwise
+     */
+    bool saveToFile(const std::string &filepath, int32_t version) const
+    {
+        std::string buffer(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        int32_t header[3] = {version, (int32_t)payload.size(),
+                             (int32_t)snapshotChecksum(payload.data(), payload.size())};
+        buffer.append(reinterpret_cast<const char *>(header), sizeof(header));
+        buffer += payload;
+
+        AtomicFile file(filepath);
+        if (!file.isOpen() || fwrite(buffer.data(), 1, buffer.size(), file.get()) != buffer.size())
+        {
+            return false;
+        }
+        return file.commit();
+    }
+};
+
+/**
+ * Read-only view over a string column inside a loaded snapshot
+ */
+struct SnapshotStringColumn
+{
+    const int32_t *offsets;
+    const char *heap;
+
+    SnapshotStringColumn() : offsets(nullptr), heap(nullptr) {}
+
+    std::string get(int index) const
+    {
+        return std::string(heap + offsets[index], offsets[index + 1] - offsets[index]);
+    }
+
+    /**
+     * Reads a string in place, without copying it (e.g. to intern it)
+     * @param index Position of the string in the column
+     * @return A view into the loaded snapshot, valid while the reader is alive
+     */
+    std::string_view view(int index) const
+    {
+        return std::string_view(heap + offsets[index], offsets[index + 1] - offsets[index]);
+    }
+};
+
+/**
+ * Loads a snapshot file in one read, validates it and hands out columns in place
+ */
+class SnapshotReader
+{
+private:
+    std::string buffer;
+    size_t pos;
+
+    // Hands out the next block, checking that it and its padding lie inside the buffer
+    const char *take(size_t length)
+    {
+        size_t remaining = buffer.size() - pos;
+        if (length > remaining || (length + 3) / 4 * 4 > remaining)
+        {
+            throw std::runtime_error("Snapshot section out of range");
+        }
+        const char *data = buffer.data() + pos;
+        pos += (length + 3) / 4 * 4;
+        return data;
+    }
+
+public:
+    SnapshotReader() : pos(0) {}
+
+    /**
+     * Reads a snapshot file and checks its magic, version and checksum
+     * @param filepath Path of the snapshot file to read
+     * @param version The format version the caller understands
+     * @return true if the snapshot is complete and valid, false otherwise
+     */
+    bool open(const std::string &filepath, int32_t version)
+    {
+        FILE *file = fopen(filepath.c_str(), "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+        fseek(file, 0, SEEK_END);
+        long length = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (length < 16)
+        {
+            fclose(file);
+            return false;
+        }
+        buffer.resize((size_t)length);
+        size_t read = fread(&buffer[0], 1, buffer.size(), file);
+        fclose(file);
+        if (read != buffer.size() || memcmp(buffer.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+        {
+            return false;
+        }
+
+        int32_t header[3];
+        memcpy(header, buffer.data() + sizeof(SNAPSHOT_MAGIC), sizeof(header));
+        size_t payloadSize = (size_t)header[1];
+        if (header[0] != version || payloadSize != buffer.size() - 16 ||
+            (int32_t)snapshotChecksum(buffer.data() + 16, payloadSize) != header[2])
+        {
+            return false;
+        }
+
+        pos = 16;
+        return true;
+    }
+
+    /**
+     * Reads a single int32 value
+     * @return The value at the current position
+     */
+    int32_t readInt()
+    {
+        int32_t value;
+        memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    /**
+     * Reads a single int64 value
+     * @return The value at the current position
+     */
+    int64_t readInt64()
+    {
+        int64_t value;
+        memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    /**
+     * Returns a pointer to an int32 column stored in the snapshot buffer
+     * @param count Number of values in the column
+     * @return Pointer to the first value; valid for the lifetime of the reader
+     */
+    const int32_t *readIntColumn(int count)
+    {
+        if (count < 0)
+        {
+            throw std::runtime_error("Snapshot column has a negative length");
+        }
+        return reinterpret_cast<const int32_t *>(take(sizeof(int32_t) * count));
+    }
+
+    /**
+     * Returns a view over a string column stored in the snapshot buffer
+     * @param count Number of strings in the column
+     * @return Column view; valid for the lifetime of the reader
+     */
+    SnapshotStringColumn readStringColumn(int count)
+    {
+        SnapshotStringColumn column;
+        column.offsets = readIntColumn(count + 1);
+
+        // The offsets must start at 0 and never decrease, so every string lies inside the heap
+        if (column.offsets[0] != 0)
+        {
+            throw std::runtime_error("Snapshot string column is corrupt");
+        }
+        for (int i = 0; i < count; i++)
+        {
+            if (column.offsets[i + 1] < column.offsets[i])
+            {
+                throw std::runtime_error("Snapshot string column is corrupt");
+            }
+        }
+        column.heap = take((size_t)column.offsets[count]);
+        return column;
+    }
+};
+
+#endif
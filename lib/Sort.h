@@ -2,113 +2,665 @@
 #define SORT_H
 
 #include <functional>
+#include <utility>
+#include <thread>
+#include <cstdint>
+#include <type_traits>
 #include "Vector.h"
 
 namespace Sort
 {
+    /// Ranges at or below this size are finished with insertion sort
+    const int INSERTION_SORT_THRESHOLD = 16;
+
     /**
-     * Median-of-three pivot selection helper for improved quicksort performance
-     * Rearranges elements to place the median of first, middle, and last elements at the end
-     * @param vec The vector to operate on
-     * @param low The starting index of the range
-     * @param high The ending index of the range
+     * Insertion sort on a small range, shifting elements with moves instead of swaps
+     * @param data Pointer to the elements
+     * @param first Index of the first element of the range
+     * @param last Index one past the last element of the range
      * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
      */
     template <typename T, typename Compare>
-    void medianOfThree(Vector<T> &vec, int low, int high, Compare compare)
+    void insertionSort(T *data, int first, int last, Compare &compare)
     {
-        int mid = (high + low) / 2;
+        for (int i = first + 1; i < last; i++)
+        {
+            if (compare(data[i], data[i - 1]) >= 0)
+                continue;
+
+            T value = std::move(data[i]);
+            int j = i;
+            do
+            {
+                data[j] = std::move(data[j - 1]);
+                j--;
+            } while (j > first && compare(value, data[j - 1]) < 0);
+            data[j] = std::move(value);
+        }
+    }
 
-        if (compare(vec[mid], vec[low]) < 0)
+    /**
+     * Restores the max-heap property below one node of a heap stored in data[first, first + size)
+     * @param data Pointer to the elements
+     * @param first Index of the heap root
+     * @param node Heap position (0-based, relative to first) to sift down from
+     * @param size Number of elements in the heap
+     * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
+     */
+    template <typename T, typename Compare>
+    void siftDown(T *data, int first, int node, int size, Compare &compare)
+    {
+        T value = std::move(data[first + node]);
+        while (true)
         {
-            T temp = vec[low];
-            vec[low] = vec[mid];
-            vec[mid] = temp;
+            int child = 2 * node + 1;
+            if (child >= size)
+                break;
+            if (child + 1 < size && compare(data[first + child], data[first + child + 1]) < 0)
+                child++;
+            if (compare(value, data[first + child]) >= 0)
+                break;
+            data[first + node] = std::move(data[first + child]);
+            node = child;
         }
-        if (compare(vec[high], vec[low]) < 0)
+        data[first + node] = std::move(value);
+    }
+
+    /**
+     * Heapsort on a range; used when quicksort recursion gets too deep, so the worst case stays O(n log n)
+     * @param data Pointer to the elements
+     * @param first Index of the first element of the range
+     * @param last Index one past the last element of the range
+     * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
+     */
+    template <typename T, typename Compare>
+    void heapSort(T *data, int first, int last, Compare &compare)
+    {
+        int size = last - first;
+        for (int node = size / 2 - 1; node >= 0; node--)
         {
-            T temp = vec[low];
-            vec[low] = vec[high];
-            vec[high] = temp;
+            siftDown(data, first, node, size, compare);
         }
-        if (compare(vec[high], vec[mid]) < 0)
+        for (int end = size - 1; end > 0; end--)
         {
-            T temp = vec[mid];
-            vec[mid] = vec[high];
-            vec[high] = temp;
+            std::swap(data[first], data[first + end]);
+            siftDown(data, first, 0, end, compare);
         }
-
-        T temp = vec[mid];
-        vec[mid] = vec[high];
-        vec[high] = temp;
     }
 
     /**
-     * Partitions the vector around a pivot using median-of-three selection
-     * Elements less than pivot are moved to the left, greater to the right
-     * @param vec The vector to partition
-     * @param low The starting index of the range to partition
-     * @param high The ending index of the range to partition
+     * Median-of-three pivot selection helper
+     * Orders the first, middle and last elements of the range and returns a copy of the median
+     * @param data Pointer to the elements
+     * @param first Index of the first element of the range
+     * @param last Index one past the last element of the range
      * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
-     * @return The final position of the pivot element
+     * @return The pivot value
      */
     template <typename T, typename Compare>
-    int partition(Vector<T> &vec, int low, int high, Compare compare)
+    T medianOfThree(T *data, int first, int last, Compare &compare)
     {
-        medianOfThree(vec, low, high, compare);
+        int mid = first + (last - first) / 2;
+        int high = last - 1;
+
+        if (compare(data[mid], data[first]) < 0)
+            std::swap(data[first], data[mid]);
+        if (compare(data[high], data[first]) < 0)
+            std::swap(data[first], data[high]);
+        if (compare(data[high], data[mid]) < 0)
+            std::swap(data[mid], data[high]);
+
+        return data[mid];
+    }
 
-        T pivot = vec[high];
-        int i = low - 1;
+    /**
+     * Three-way partition around a median-of-three pivot (Bentley-McIlroy)
+     * Afterwards data[first, lt) < pivot, data[lt, gt) == pivot and data[gt, last) > pivot,
+     * so runs of equal keys are placed in one pass and never recursed into.
+     * Scans inward from both ends like Hoare's partition, swapping only pairs that are on the
+     * wrong side, and parks keys equal to the pivot at the two ends until the scans meet, then
+     * swaps them into the middle. Already ordered ranges are left almost untouched.
+     * @param data Pointer to the elements
+     * @param first Index of the first element of the range
+     * @param last Index one past the last element of the range
+     * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
+     * @param lt Set to the start of the block equal to the pivot
+     * @param gt Set to one past the end of the block equal to the pivot
+     */
+    template <typename T, typename Compare>
+    void partition(T *data, int first, int last, Compare &compare, int &lt, int &gt)
+    {
+        T pivot = medianOfThree(data, first, last, compare);
 
-        for (int j = low; j < high; j++)
+        // data[first, leftEqual) and data[rightEqual, last) hold keys equal to the pivot
+        int i = first, j = last - 1;
+        int leftEqual = first, rightEqual = last;
+        while (true)
         {
-            if (compare(vec[j], pivot) < 0)
+            int order;
+            while (i <= j && (order = compare(data[i], pivot)) <= 0)
             {
+                if (order == 0)
+                    std::swap(data[leftEqual++], data[i]);
                 i++;
-                T temp = vec[i];
-                vec[i] = vec[j];
-                vec[j] = temp;
             }
+            while (i <= j && (order = compare(data[j], pivot)) >= 0)
+            {
+                if (order == 0)
+                    std::swap(data[j], data[--rightEqual]);
+                j--;
+            }
+            if (i > j)
+                break;
+            std::swap(data[i++], data[j--]);
         }
 
-        T temp = vec[i + 1];
-        vec[i + 1] = vec[high];
-        vec[high] = temp;
+        // Now data[leftEqual, i) < pivot and data[i, rightEqual) > pivot; move the equal keys between them
+        int lessCount = i - leftEqual;
+        int moved = leftEqual - first < lessCount ? leftEqual - first : lessCount;
+        for (int k = 0; k < moved; k++)
+            std::swap(data[first + k], data[i - moved + k]);
+
+        int greaterCount = rightEqual - i;
+        moved = last - rightEqual < greaterCount ? last - rightEqual : greaterCount;
+        for (int k = 0; k < moved; k++)
+            std::swap(data[i + k], data[last - moved + k]);
 
-        return i + 1;
+        lt = first + lessCount;
+        gt = i + (last - rightEqual);
     }
 
     /**
-     * Recursive helper function for quicksort implementation
-     * @param vec The vector to sort
-     * @param low The starting index of the range to sort
-     * @param high The ending index of the range to sort
+     * Introsort loop: quicksort until ranges are small or recursion is too deep
+     * Recurses into the smaller side and loops on the larger, so the stack stays O(log n)
+     * @param data Pointer to the elements
+     * @param first Index of the first element of the range
+     * @param last Index one past the last element of the range
+     * @param depthLimit Partitions left before falling back to heapsort
      * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
      */
     template <typename T, typename Compare>
-    void quicksortHelper(Vector<T> &vec, int low, int high, Compare compare)
+    void introsortLoop(T *data, int first, int last, int depthLimit, Compare &compare)
+    {
+        while (last - first > INSERTION_SORT_THRESHOLD)
+        {
+            if (depthLimit == 0)
+            {
+                heapSort(data, first, last, compare);
+                return;
+            }
+            depthLimit--;
+
+            int lt, gt;
+            partition(data, first, last, compare, lt, gt);
+            if (lt - first < last - gt)
+            {
+                introsortLoop(data, first, lt, depthLimit, compare);
+                first = gt;
+            }
+            else
+            {
+                introsortLoop(data, gt, last, depthLimit, compare);
+                last = lt;
+            }
+        }
+        insertionSort(data, first, last, compare);
+    }
+
+    /**
+     * Number of partitioning levels allowed before introsort falls back to heapsort
+     * @param size Number of elements being sorted
+     * @return 2 * floor(log2(size))
+     */
+    inline int introsortDepthLimit(int size)
     {
-        if (low < high)
+        int depthLimit = 0;
+        for (int n = size; n > 1; n >>= 1)
         {
-            int pivotIndex = partition(vec, low, high, compare);
-            quicksortHelper(vec, low, pivotIndex - 1, compare);
-            quicksortHelper(vec, pivotIndex + 1, high, compare);
+            depthLimit += 2;
         }
+        return depthLimit;
     }
 
     /**
-     * In-place quicksort with median-of-three pivot selection
-     * Sorts the entire vector using the provided comparison function
+     * In-place introsort (quicksort with three-way partitioning, a heapsort fallback and an
+     * insertion sort for small ranges). Worst case O(n log n); not stable.
      * @param vec The vector to sort in-place
      * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
      */
     template <typename T, typename Compare>
     void quicksort(Vector<T> &vec, Compare compare)
     {
-        if (vec.getSize() > 1)
+        int size = vec.getSize();
+        if (size < 2)
+            return;
+
+        introsortLoop(vec.data(), 0, size, introsortDepthLimit(size), compare);
+    }
+
+    /**
+     * Rearranges a vector so the element at index n is the one that would be there if the vector
+     * were sorted, with no greater element before it and no smaller element after it.
+     * Quickselect on the three-way partition, O(n) on average; after too many partitions the
+     * remaining range is simply sorted, so the worst case stays O(n log n).
+     * @param vec The vector to rearrange in-place
+     * @param n The index to place correctly; nothing happens if it is out of range
+     * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
+     */
+    template <typename T, typename Compare>
+    void nthElement(Vector<T> &vec, int n, Compare compare)
+    {
+        int first = 0;
+        int last = vec.getSize();
+        if (n < 0 || n >= last)
+            return;
+
+        T *data = vec.data();
+        int depthLimit = introsortDepthLimit(last);
+        while (last - first > INSERTION_SORT_THRESHOLD)
         {
-            quicksortHelper(vec, 0, vec.getSize() - 1, compare);
+            if (depthLimit == 0)
+            {
+                introsortLoop(data, first, last, introsortDepthLimit(last - first), compare);
+                return;
+            }
+            depthLimit--;
+
+            int lt, gt;
+            partition(data, first, last, compare, lt, gt);
+            if (n < lt)
+                last = lt;
+            else if (n >= gt)
+                first = gt;
+            else
+                return; // n falls in the block equal to the pivot
         }
+        insertionSort(data, first, last, compare);
+    }
+
+    /**
+     * Sorts only the k smallest elements into the front of a vector, leaving the rest in
+     * unspecified order. O(n + k log k), for when only the first page of results is shown.
+     * @param vec The vector to rearrange in-place
+     * @param k Number of leading elements to sort (clamped to the vector size)
+     * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
+     */
+    template <typename T, typename Compare>
+    void partialSort(Vector<T> &vec, int k, Compare compare)
+    {
+        int size = vec.getSize();
+        if (k > size)
+            k = size;
+        if (k <= 0)
+            return;
+
+        if (k < size)
+            nthElement(vec, k - 1, compare);
+        introsortLoop(vec.data(), 0, k, introsortDepthLimit(k), compare);
+    }
+
+    /// Natural runs shorter than this are extended with insertion sort before merging
+    const int MIN_MERGE_RUN = 32;
+
+    /**
+     * Merges the sorted neighbouring ranges data[first, mid) and data[mid, last), keeping equal
+     * elements in their original order. Only the shorter range is moved into the buffer.
+     * @param data Pointer to the elements
+     * @param first Index of the first element of the left range
+     * @param mid Index of the first element of the right range
+     * @param last Index one past the last element of the right range
+     * @param buffer Scratch space holding at least min(mid - first, last - mid) elements
+     * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
+     */
+    template <typename T, typename Compare>
+    void mergeRuns(T *data, int first, int mid, int last, T *buffer, Compare &compare)
+    {
+        // Runs taken from already ordered data often need no merging at all
+        if (compare(data[mid - 1], data[mid]) <= 0)
+            return;
+
+        if (mid - first <= last - mid)
+        {
+            // Move the left run out and merge front to back
+            int leftSize = mid - first;
+            for (int i = 0; i < leftSize; i++)
+                buffer[i] = std::move(data[first + i]);
+
+            int b = 0, r = mid, out = first;
+            while (b < leftSize && r < last)
+            {
+                if (compare(data[r], buffer[b]) < 0)
+                    data[out++] = std::move(data[r++]);
+                else
+                    data[out++] = std::move(buffer[b++]);
+            }
+            while (b < leftSize)
+                data[out++] = std::move(buffer[b++]);
+        }
+        else
+        {
+            // Move the right run out and merge back to front
+            int rightSize = last - mid;
+            for (int i = 0; i < rightSize; i++)
+                buffer[i] = std::move(data[mid + i]);
+
+            int b = rightSize - 1, l = mid - 1, out = last - 1;
+            while (b >= 0 && l >= first)
+            {
+                if (compare(buffer[b], data[l]) < 0)
+                    data[out--] = std::move(data[l--]);
+                else
+                    data[out--] = std::move(buffer[b--]);
+            }
+            while (b >= 0)
+                data[out--] = std::move(buffer[b--]);
+        }
+    }
+
+    /**
+     * Stable, adaptive merge sort of one range in the style of TimSort
+     * Existing ascending runs (and strictly descending ones, which are reversed) are detected and
+     * merged; short runs are extended with insertion sort.
+     * @param data Pointer to the elements
+     * @param first Index of the first element of the range
+     * @param last Index one past the last element of the range
+     * @param buffer Scratch space holding at least (last - first) / 2 + 1 elements
+     * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
+     */
+    template <typename T, typename Compare>
+    void stableSortRange(T *data, int first, int last, T *buffer, Compare &compare)
+    {
+        if (last - first <= MIN_MERGE_RUN)
+        {
+            insertionSort(data, first, last, compare);
+            return;
+        }
+
+        Vector<int> runStarts;
+        Vector<int> runEnds;
+
+        int start = first;
+        while (start < last)
+        {
+            // Find the natural run starting here
+            int end = start + 1;
+            if (end < last)
+            {
+                if (compare(data[end], data[start]) < 0)
+                {
+                    while (end < last && compare(data[end], data[end - 1]) < 0)
+                        end++;
+                    for (int i = start, j = end - 1; i < j; i++, j--)
+                        std::swap(data[i], data[j]);
+                }
+                else
+                {
+                    while (end < last && compare(data[end], data[end - 1]) >= 0)
+                        end++;
+                }
+            }
+            if (end - start < MIN_MERGE_RUN)
+            {
+                end = start + MIN_MERGE_RUN < last ? start + MIN_MERGE_RUN : last;
+                insertionSort(data, start, end, compare);
+            }
+            runStarts.append(start);
+            runEnds.append(end);
+
+            // Merge neighbouring runs until run lengths shrink geometrically down the stack,
+            // which keeps merges balanced and the stack O(log n) deep
+            while (runStarts.getSize() > 1)
+            {
+                int n = runStarts.getSize();
+                int c = runEnds[n - 1] - runStarts[n - 1];
+                int b = runEnds[n - 2] - runStarts[n - 2];
+                int a = n > 2 ? runEnds[n - 3] - runStarts[n - 3] : b + c + 1;
+                int at;
+                if (a <= b + c)
+                    at = a < c ? n - 3 : n - 2;
+                else if (b <= c)
+                    at = n - 2;
+                else
+                    break;
+
+                mergeRuns(data, runStarts[at], runEnds[at], runEnds[at + 1], buffer, compare);
+                runEnds[at] = runEnds[at + 1];
+                runStarts.remove(at + 1);
+                runEnds.remove(at + 1);
+            }
+            start = end;
+        }
+
+        while (runStarts.getSize() > 1)
+        {
+            int at = runStarts.getSize() - 2;
+            mergeRuns(data, runStarts[at], runEnds[at], runEnds[at + 1], buffer, compare);
+            runEnds[at] = runEnds[at + 1];
+            runStarts.remove(at + 1);
+            runEnds.remove(at + 1);
+        }
+    }
+
+    /**
+     * Stable, adaptive merge sort in the style of TimSort
+     * Data that is already nearly in order, like time-ordered borrow records, sorts in close to
+     * O(n). Worst case O(n log n), with n / 2 elements of scratch space.
+     * @param vec The vector to sort in-place
+     * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
+     */
+    template <typename T, typename Compare>
+    void stableSort(Vector<T> &vec, Compare compare)
+    {
+        int size = vec.getSize();
+        if (size < 2)
+            return;
+
+        T *buffer = new T[size / 2 + 1];
+        stableSortRange(vec.data(), 0, size, buffer, compare);
+        delete[] buffer;
+    }
+
+    /// Vectors smaller than this (65,536 elements) are sorted on the calling thread
+    const int PARALLEL_SORT_THRESHOLD = 1 << 16;
+
+    /// Smallest slice worth handing to its own thread
+    const int PARALLEL_SORT_MIN_SLICE = 1 << 14;
+
+    /**
+     * Stable merge sort spread over the available cores with fork-join threads
+     * The vector is cut into one slice per thread (a power of two), each slice is sorted with
+     * stableSort's algorithm, and neighbouring slices are then merged pairwise, each round of
+     * merges also running in parallel. Below PARALLEL_SORT_THRESHOLD, or on a single core, this
+     * is just stableSort and no thread is started.
+     * Its one caller is TimeIndex::build, for the borrow log at load time; the sample data is far
+     * below the threshold, so threads are only used once the log reaches tens of thousands of borrows.
+     * The comparator may be called from several threads at once, so it must not modify shared state.
+     * @param vec The vector to sort in-place
+     * @param compare Comparison function returning negative if a < b, 0 if a == b, positive if a > b
+     */
+    template <typename T, typename Compare>
+    void parallelSort(Vector<T> &vec, Compare compare)
+    {
+        int size = vec.getSize();
+        unsigned int cores = std::thread::hardware_concurrency();
+        int slices = 1;
+        while (slices * 2 <= (int)cores && size / (slices * 2) >= PARALLEL_SORT_MIN_SLICE)
+        {
+            slices *= 2;
+        }
+        if (size < PARALLEL_SORT_THRESHOLD || slices < 2)
+        {
+            stableSort(vec, compare);
+            return;
+        }
+
+        T *data = vec.data();
+        // Each slice and each merge only touches the part of the buffer under its own range
+        T *buffer = new T[size];
+        Vector<int> bounds;
+        for (int i = 0; i <= slices; i++)
+        {
+            bounds.append((int)((long long)size * i / slices));
+        }
+
+        std::thread *workers = new std::thread[slices];
+        for (int i = 0; i < slices; i++)
+        {
+            int first = bounds[i];
+            int last = bounds[i + 1];
+            workers[i] = std::thread([=, &compare]()
+                                     { stableSortRange(data, first, last, buffer + first, compare); });
+        }
+        for (int i = 0; i < slices; i++)
+        {
+            workers[i].join();
+        }
+
+        for (int width = 1; width < slices; width *= 2)
+        {
+            int merges = 0;
+            for (int i = 0; i + width < slices; i += 2 * width)
+            {
+                int first = bounds[i];
+                int mid = bounds[i + width];
+                int last = bounds[i + 2 * width];
+                workers[merges++] = std::thread([=, &compare]()
+                                                { mergeRuns(data, first, mid, last, buffer + first, compare); });
+            }
+            for (int i = 0; i < merges; i++)
+            {
+                workers[i].join();
+            }
+        }
+        delete[] workers;
+        delete[] buffer;
+    }
+
+    /**
+     * Stable LSD radix sort on an integer key, in O(n) for a fixed key width
+     * Keys of up to 32 bits take four 8-bit passes and 64-bit keys take eight; passes where every
+     * key has the same digit (e.g. the high bytes of nearby timestamps) are skipped. Signed keys
+     * order negatives first. Keys are extracted once and elements are moved once, at the end.
+     * e.g. Sort::radixSortBy(reviews, [](const Review &r) { return r.reviewId; }, true)
+     * @param vec The vector to sort in-place
+     * @param key Function returning the integer key of an element
+     * @param descending True to order largest keys first (ties still keep their original order)
+     */
+    template <typename T, typename KeyFn>
+    void radixSortBy(Vector<T> &vec, KeyFn key, bool descending = false)
+    {
+        typedef typename std::decay<decltype(key(std::declval<const T &>()))>::type Key;
+        static_assert(std::is_integral<Key>::value, "radixSortBy needs an integer key");
+        typedef typename std::conditional<(sizeof(Key) > 4), uint64_t, uint32_t>::type Bits;
+        const int KEY_BITS = sizeof(Bits) * 8;
+
+        int size = vec.getSize();
+        if (size < 2)
+            return;
+
+        T *data = vec.data();
+        Bits *keys = new Bits[size];
+        Bits *keysOut = new Bits[size];
+        int *order = new int[size];
+        int *orderOut = new int[size];
+
+        for (int i = 0; i < size; i++)
+        {
+            // Flipping the sign bit makes signed keys order correctly as unsigned ones
+            Bits bits = (Bits)key(data[i]);
+            if (std::is_signed<Key>::value)
+                bits ^= (Bits)1 << (KEY_BITS - 1);
+            keys[i] = descending ? ~bits : bits;
+            order[i] = i;
+        }
+
+        for (int shift = 0; shift < KEY_BITS; shift += 8)
+        {
+            int counts[257] = {0};
+            for (int i = 0; i < size; i++)
+            {
+                counts[((keys[i] >> shift) & 0xFF) + 1]++;
+            }
+            if (counts[((keys[0] >> shift) & 0xFF) + 1] == size)
+                continue;
+
+            for (int digit = 0; digit < 256; digit++)
+            {
+                counts[digit + 1] += counts[digit];
+            }
+            for (int i = 0; i < size; i++)
+            {
+                int position = counts[(keys[i] >> shift) & 0xFF]++;
+                keysOut[position] = keys[i];
+                orderOut[position] = order[i];
+            }
+            std::swap(keys, keysOut);
+            std::swap(order, orderOut);
+        }
+
+        T *sorted = new T[size];
+        for (int i = 0; i < size; i++)
+        {
+            sorted[i] = std::move(data[order[i]]);
+        }
+        for (int i = 0; i < size; i++)
+        {
+            data[i] = std::move(sorted[i]);
+        }
+
+        delete[] sorted;
+        delete[] keys;
+        delete[] keysOut;
+        delete[] order;
+        delete[] orderOut;
+    }
+
+    /**
+     * Builds a comparator that orders elements by a key, using the key type's < operator
+     * e.g. Sort::by([](const Borrow &b) { return b.dateBorrowed; })
+     * @param key Function returning the key of an element
+     * @return Comparison function returning negative, 0 or positive
+     */
+    template <typename KeyFn>
+    auto by(KeyFn key)
+    {
+        return [key](const auto &a, const auto &b) -> int
+        {
+            auto keyA = key(a);
+            auto keyB = key(b);
+            if (keyA < keyB)
+                return -1;
+            return keyB < keyA ? 1 : 0;
+        };
+    }
+
+    /**
+     * Reverses the order of a comparator
+     * @param compare Comparison function returning negative, 0 or positive
+     * @return Comparison function ordering elements the opposite way
+     */
+    template <typename Compare>
+    auto descending(Compare compare)
+    {
+        return [compare](const auto &a, const auto &b) -> int
+        { return compare(b, a); };
+    }
+
+    /**
+     * Chains two comparators: ties under the first are broken by the second
+     * e.g. Sort::thenBy(Sort::by(dateOf), Sort::by(idOf)); chains nest for more keys
+     * @param first Comparison function for the primary key
+     * @param second Comparison function used when the primary keys are equal
+     * @return The combined comparison function
+     */
+    template <typename First, typename Second>
+    auto thenBy(First first, Second second)
+    {
+        return [first, second](const auto &a, const auto &b) -> int
+        {
+            int order = first(a, b);
+            return order != 0 ? order : second(a, b);
+        };
     }
 }
 
@@ -0,0 +1,258 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <cstring>
+#include "Hash.h"
+#include "Vector.h"
+
+/// Compact handle to a string interned in StringPool::global().
+/// Equal strings always get the same handle, so comparing handles compares the strings.
+/// The default handle is the empty string.
+struct StringHandle
+{
+    uint32_t id;
+
+    StringHandle() : id(0) {}
+    explicit StringHandle(uint32_t id) : id(id) {}
+
+    bool operator==(const StringHandle &other) const { return id == other.id; }
+    bool operator!=(const StringHandle &other) const { return id != other.id; }
+
+    // Orders handles by interning order, not alphabetically (compare c_str() for that)
+    bool operator<(const StringHandle &other) const { return id < other.id; }
+    bool operator>(const StringHandle &other) const { return id > other.id; }
+
+    const char *c_str() const;
+    std::string_view view() const;
+    std::string str() const;
+};
+
+/// Hashes a handle by its id, which is already unique per string, so no characters are read.
+template <>
+inline unsigned int hash<StringHandle>(const StringHandle &handle)
+{
+    return handle.id;
+}
+
+/*
+ * Interns strings: each distinct string is stored once, NUL-terminated, in large chunks that
+ * never move, and is named by a 32-bit StringHandle. Handles compare and hash in O(1), and
+ * each string's hash is computed once on interning and kept, so the lookup table grows
+ * without rehashing any text. Strings are never removed.
+ * Not thread-safe: intern from one thread only.
+ */
+class StringPool
+{
+private:
+    static const int CHUNK_SIZE = 64 * 1024;
+
+    Vector<char *> chunks;
+    int chunkUsed;               // bytes used in the last chunk
+    int chunkCapacity;           // size of the last chunk
+    Vector<const char *> starts; // starts[id] = the characters of string id
+    Vector<int> lengths;
+    Vector<unsigned int> hashes;
+    Vector<int> slots; // open-addressing table of string ids (-1 = empty); its size is a power of two
+
+    // FNV-1a, which spreads the low bits well enough to mask them into a slot
+    static unsigned int hashChars(std::string_view text)
+    {
+        unsigned int hashValue = 2166136261u;
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            hashValue = (hashValue ^ (unsigned char)text[i]) * 16777619u;
+        }
+        return hashValue;
+    }
+
+    // Copies a string into the current chunk, starting a new chunk if it does not fit
+    const char *store(std::string_view text)
+    {
+        int needed = (int)text.size() + 1;
+        if (chunks.isEmpty() || chunkUsed + needed > chunkCapacity)
+        {
+            chunkCapacity = needed > CHUNK_SIZE ? needed : CHUNK_SIZE;
+            chunks.append(new char[chunkCapacity]);
+            chunkUsed = 0;
+        }
+        char *destination = chunks[chunks.getSize() - 1] + chunkUsed;
+        memcpy(destination, text.data(), text.size());
+        destination[text.size()] = '\0';
+        chunkUsed += needed;
+        return destination;
+    }
+
+    // Finds the slot holding a string, or the empty slot where it would go
+    int findSlot(std::string_view text, unsigned int textHash) const
+    {
+        int mask = slots.getSize() - 1;
+        for (int slot = (int)(textHash & mask);; slot = (slot + 1) & mask)
+        {
+            int id = slots[slot];
+            if (id == -1 ||
+                (hashes[id] == textHash && lengths[id] == (int)text.size() &&
+                 memcmp(starts[id], text.data(), text.size()) == 0))
+            {
+                return slot;
+            }
+        }
+    }
+
+    // Doubles the table, placing every string by its stored hash
+    void grow()
+    {
+        int capacity = slots.getSize() * 2;
+        slots = Vector<int>(capacity);
+        for (int i = 0; i < capacity; i++)
+        {
+            slots.append(-1);
+        }
+
+        int mask = capacity - 1;
+        for (int id = 0; id < starts.getSize(); id++)
+        {
+            int slot = (int)(hashes[id] & mask);
+            while (slots[slot] != -1)
+            {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = id;
+        }
+    }
+
+public:
+    StringPool() : chunks(4), chunkUsed(0), chunkCapacity(0), slots(64)
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            slots.append(-1);
+        }
+        intern(""); // id 0, so a default StringHandle is the empty string
+    }
+
+    ~StringPool()
+    {
+        for (int i = 0; i < chunks.getSize(); i++)
+        {
+            delete[] chunks[i];
+        }
+    }
+
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    /*
+     * The pool shared by every model and index, which StringHandle reads from.
+     * Parameters: none
+     * Returns: the global pool
+     */
+    static StringPool &global()
+    {
+        static StringPool pool;
+        return pool;
+    }
+
+    /*
+     * Returns the handle for a string, storing the string if it is new.
+     * Parameters: text - the string to intern
+     * Returns: the string's handle
+     */
+    StringHandle intern(std::string_view text)
+    {
+        unsigned int textHash = hashChars(text);
+        int slot = findSlot(text, textHash);
+        if (slots[slot] != -1)
+        {
+            return StringHandle((uint32_t)slots[slot]);
+        }
+
+        int id = starts.getSize();
+        starts.append(store(text));
+        lengths.append((int)text.size());
+        hashes.append(textHash);
+        slots[slot] = id;
+
+        // Keep the load factor at or below 0.5 so probe runs stay short
+        if (starts.getSize() * 2 > slots.getSize())
+        {
+            grow();
+        }
+        return StringHandle((uint32_t)id);
+    }
+
+    /*
+     * Looks a string up without interning it, e.g. for text typed by a user.
+     * Parameters: text - the string to look for
+     * Returns: its handle, or std::nullopt if the string was never interned
+     */
+    std::optional<StringHandle> find(std::string_view text) const
+    {
+        int id = slots[findSlot(text, hashChars(text))];
+        if (id == -1)
+        {
+            return std::nullopt;
+        }
+        return StringHandle((uint32_t)id);
+    }
+
+    /*
+     * Returns the characters of an interned string. The pointer stays valid for the life of the pool.
+     * Parameters: handle - the string's handle
+     * Returns: a NUL-terminated string
+     */
+    const char *c_str(StringHandle handle) const
+    {
+        return starts[handle.id];
+    }
+
+    std::string_view view(StringHandle handle) const
+    {
+        return std::string_view(starts[handle.id], lengths[handle.id]);
+    }
+
+    int length(StringHandle handle) const
+    {
+        return lengths[handle.id];
+    }
+
+    /*
+     * Returns the hash computed when a string was interned.
+     * Parameters: handle - the string's handle
+     * Returns: the string's hash
+     */
+    unsigned int hashOf(StringHandle handle) const
+    {
+        return hashes[handle.id];
+    }
+
+    /*
+     * Returns the number of distinct strings in the pool, including the empty string.
+     * Parameters: none
+     * Returns: the string count
+     */
+    int getSize() const
+    {
+        return starts.getSize();
+    }
+};
+
+inline const char *StringHandle::c_str() const
+{
+    return StringPool::global().c_str(*this);
+}
+
+inline std::string_view StringHandle::view() const
+{
+    return StringPool::global().view(*this);
+}
+
+inline std::string StringHandle::str() const
+{
+    return std::string(view());
+}
+
+#endif
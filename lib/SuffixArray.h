@@ -5,6 +5,7 @@
 #include <stdexcept>
 #include <cctype>
 #include <functional>
+#include <cstdint>
 #include "Vector.h"
 #include "Set.h"
 #include "Search.h"
@@ -57,65 +58,116 @@ public:
     {
     }
 
+    /**
+     * Restores a previously built suffix array without re-sorting its suffixes
+     * @param text The combined lowercase text the suffixes point into
+     * @param suffixes The suffix entries, already in sorted order
+     * @return A SuffixArray equivalent to the one the parts were taken from
+     */
+    static SuffixArray fromParts(const std::string &text, const Vector<SuffixEntry> &suffixes)
+    {
+        SuffixArray sa;
+        sa.text = text;
+        sa.suffixes = suffixes;
+        sa.size = text.length();
+        return sa;
+    }
+
+    /**
+     * Gets the combined lowercase text of all indexed items
+     * @return The text the suffix entries point into
+     */
+    const std::string &getText() const
+    {
+        return text;
+    }
+
+    /**
+     * Gets the suffix entries in sorted order
+     * @return The sorted suffix entries
+     */
+    const Vector<SuffixEntry> &getSuffixes() const
+    {
+        return suffixes;
+    }
+
     /**
      * Builds a suffix array from multiple strings for efficient substring searching
-     * @param data Vector of items to build the suffix array from
-     * @param getContent Function to extract string content from each item
-     * @param getId Function to extract unique ID from each item
+     * @param data Items to build the suffix array from (a Vector, or any View such as indexRange())
+     * @param getContent Function (any callable) to extract string content from each item
+     * @param getId Function (any callable) to extract unique ID from each item
      * @return A SuffixArray containing all suffixes sorted lexicographically
      */
-    template <typename T>
+    template <typename Items, typename GetContent, typename GetId>
     static SuffixArray build(
-        const Vector<T> &data,
-        std::function<std::string(const T &)> getContent,
-        std::function<int(const T &)> getId)
+        const Items &data,
+        GetContent getContent,
+        GetId getId)
     {
         SuffixArray sa;
 
-        for (int i = 0, k = 0; i < data.getSize(); i++)
+        int k = 0;
+        int previousId = 0;
+        bool first = true;
+        for (const auto &item : data)
         {
-            if (i > 0)
+            if (!first)
             {
                 sa.text += '\x1F';
-                sa.suffixes.append(SuffixEntry(k, getId(data[i - 1])));
+                sa.suffixes.append(SuffixEntry(k, previousId));
                 k++;
             }
+            first = false;
 
-            const T &item = data[i];
             std::string content = getContent(item);
+            int id = getId(item);
             sa.text += sa.toLowerCase(content);
 
             for (int j = 0; j < content.length(); j++, k++)
             {
-                sa.suffixes.append(SuffixEntry(k, getId(item)));
+                sa.suffixes.append(SuffixEntry(k, id));
             }
+            previousId = id;
         }
 
         sa.size = sa.text.length();
 
-        auto compareFunc =
-            [&](const SuffixEntry &a, const SuffixEntry &b)
+        // Prefix doubling: once suffixes are ranked by their first k characters, ranking by the
+        // pair (rank of first k, rank of next k) orders them by 2k characters. Each round is one
+        // radix sort, and rounds stop as soon as every suffix has a distinct rank.
+        // Characters rank as unsigned bytes and the end of the text ranks lowest, matching the
+        // std::string comparisons used by search().
+        int n = (int)sa.text.length();
+        Vector<int> rankBuffers[2] = {Vector<int>(n + 1), Vector<int>(n + 1)};
+        for (int p = 0; p < n; p++)
         {
-            int pos1 = a.i;
-            int pos2 = b.i;
-
-            if (pos1 == pos2)
-                return 0;
+            rankBuffers[0].append((unsigned char)sa.text[p] + 1);
+            rankBuffers[1].append(0);
+        }
 
-            while (pos1 < (int)sa.text.length() && pos2 < (int)sa.text.length())
+        for (int k = 1, current = 0; n > 0; k *= 2, current = 1 - current)
+        {
+            const int *ranks = rankBuffers[current].data();
+            int *nextRanks = rankBuffers[1 - current].data();
+            auto pairKey = [ranks, n, k](const SuffixEntry &e)
             {
-                if (sa.text[pos1] != sa.text[pos2])
-                {
-                    return sa.text[pos1] - sa.text[pos2];
-                }
-                pos1++;
-                pos2++;
+                uint32_t second = e.i + k < n ? (uint32_t)ranks[e.i + k] : 0;
+                return ((uint64_t)ranks[e.i] << 32) | second;
+            };
+            Sort::radixSortBy(sa.suffixes, pairKey);
+
+            int distinct = 1;
+            nextRanks[sa.suffixes[0].i] = 1;
+            for (int p = 1; p < n; p++)
+            {
+                if (pairKey(sa.suffixes[p]) != pairKey(sa.suffixes[p - 1]))
+                    distinct++;
+                nextRanks[sa.suffixes[p].i] = distinct;
             }
 
-            return (pos1 == (int)sa.text.length()) ? -1 : 1;
-        };
-
-        Sort::quicksort<SuffixEntry>(sa.suffixes, compareFunc);
+            if (distinct == n || k >= n)
+                break;
+        }
 
         return sa;
     }
@@ -136,27 +188,20 @@ public:
 
         std::string lowerQuery = toLowerCase(query);
 
-        int lower = binarySearch(
-            size,
+        // Compare suffixes in place instead of copying them out of the text
+        int lower = partitionPoint(
+            (int)size,
             [&](int mid)
-            {
-                std::string suffix = text.substr(suffixes[mid].i);
-                return suffix < lowerQuery ? -1 : 1;
-            },
-            false);
+            { return text.compare(suffixes[mid].i, std::string::npos, lowerQuery) < 0; });
 
-        int upper = binarySearch(
-            size,
+        // Suffixes starting with the query are exactly those whose first query-length
+        // characters compare equal to it
+        int upper = partitionPoint(
+            (int)size,
             [&](int mid)
-            {
-                std::string suffix = text.substr(suffixes[mid].i);
-                bool suffixStartsWithQuery = suffix.length() >= lowerQuery.length() &&
-                                             suffix.substr(0, lowerQuery.length()) == lowerQuery;
-                return suffixStartsWithQuery || suffix < lowerQuery ? -1 : 1;
-            },
-            false);
-
-        Set<int> found;
+            { return text.compare(suffixes[mid].i, lowerQuery.length(), lowerQuery) <= 0; });
+
+        Set<int, ArenaAllocator> found;
         for (int i = lower; i < upper; i++)
         {
             int itemId = suffixes[i].j;
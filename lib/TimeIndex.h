@@ -0,0 +1,138 @@
+#ifndef TIME_INDEX_H
+#define TIME_INDEX_H
+
+#include "Vector.h"
+#include "Sort.h"
+#include "Search.h"
+
+/// One record in a TimeIndex: a timestamp and the key of the record it belongs to
+template <typename K>
+struct TimeIndexEntry
+{
+    int time;
+    K key;
+
+    TimeIndexEntry() : time(0), key() {}
+    TimeIndexEntry(int time, const K &key) : time(time), key(key) {}
+};
+
+/*
+ * Keys kept in (time, key) order for chronological listing and time-range queries.
+ * New records normally arrive with the latest timestamp and are appended in O(1);
+ * a record that arrives out of order is inserted at its position instead.
+ * Ranges are located by binary search and read back by position, oldest or newest first.
+ */
+template <typename K>
+class TimeIndex
+{
+private:
+    Vector<TimeIndexEntry<K>> entries;
+
+    static int compareEntries(const TimeIndexEntry<K> &a, const TimeIndexEntry<K> &b)
+    {
+        if (a.time != b.time)
+            return a.time < b.time ? -1 : 1;
+        if (a.key < b.key)
+            return -1;
+        return b.key < a.key ? 1 : 0;
+    }
+
+public:
+    /*
+     * Replaces the contents with a set of records in any order, sorting them once
+     * (close to linear when the records are already mostly in time order).
+     * The sort only spreads over several threads from Sort::PARALLEL_SORT_THRESHOLD records up.
+     * Parameters: records - the records to index
+     * Returns: nothing
+     */
+    void build(const Vector<TimeIndexEntry<K>> &records)
+    {
+        entries = records;
+        Sort::parallelSort(entries, compareEntries);
+    }
+
+    /*
+     * Adds a record, appending when it is the newest.
+     * Parameters: time - the record's timestamp, key - the record's key
+     * Returns: nothing
+     */
+    void add(int time, const K &key)
+    {
+        TimeIndexEntry<K> entry(time, key);
+        if (entries.isEmpty() || compareEntries(entries[entries.getSize() - 1], entry) <= 0)
+        {
+            entries.append(entry);
+            return;
+        }
+        int position = ::lowerBound(entries.data(), entries.getSize(), entry, compareEntries);
+        entries.insert(position, entry);
+    }
+
+    /*
+     * Removes a record.
+     * Parameters: time - the record's timestamp, key - the record's key
+     * Returns: true if the record was removed, false if it was not present
+     */
+    bool remove(int time, const K &key)
+    {
+        TimeIndexEntry<K> entry(time, key);
+        int position = binarySearch(entries.getSize(), [&](int index)
+                                    {
+            int order = compareEntries(entries[index], entry);
+            return order < 0 ? -1 : (order > 0 ? 1 : 0); });
+        if (position == -1)
+        {
+            return false;
+        }
+        entries.remove(position);
+        return true;
+    }
+
+    /*
+     * Finds the first record at or after a time.
+     * Parameters: time - the time to search for
+     * Returns: the position of the first record with timestamp >= time (getSize() if none)
+     */
+    int lowerBound(int time) const
+    {
+        return partitionPoint(entries.getSize(), [&](int index)
+                              { return entries[index].time < time; });
+    }
+
+    /*
+     * Retrieves a record by chronological position.
+     * Parameters: index - 0 for the oldest record
+     * Returns: the record at that position, or throws out_of_range if invalid
+     */
+    const TimeIndexEntry<K> &at(int index) const
+    {
+        return entries[index];
+    }
+
+    /*
+     * Retrieves a record by reverse chronological position.
+     * Parameters: index - 0 for the newest record
+     * Returns: the record at that position, or throws out_of_range if invalid
+     */
+    const TimeIndexEntry<K> &newest(int index) const
+    {
+        return entries[entries.getSize() - 1 - index];
+    }
+
+    int getSize() const
+    {
+        return entries.getSize();
+    }
+
+    bool isEmpty() const
+    {
+        return entries.isEmpty();
+    }
+
+    void clear()
+    {
+        entries.clear();
+    }
+};
+
+#endif
@@ -20,7 +20,7 @@ private:
 
     void resize()
     {
-        int newCapacity = capacity * 2;
+        int newCapacity = capacity > 0 ? capacity * 2 : 4;
         T *newItems = new T[newCapacity];
 
         for (int i = 0; i < size; i++)
@@ -113,6 +113,36 @@ public:
         return items[index];
     }
 
+    /*
+     * Gives direct access to the contiguous element storage for tight loops.
+     * Parameters: none
+     * Returns: a pointer to the first element (valid until the vector is resized or destroyed)
+     */
+    T *data()
+    {
+        return items;
+    }
+
+    /*
+     * Gives read-only access to the contiguous element storage for tight loops.
+     * Parameters: none
+     * Returns: a const pointer to the first element (valid until the vector is resized or destroyed)
+     */
+    const T *data() const
+    {
+        return items;
+    }
+
+    /*
+     * Iterators over the elements, so a vector can be used in range-based for loops and views.
+     * Parameters: none
+     * Returns: a pointer to the first element / one past the last element
+     */
+    T *begin() { return items; }
+    T *end() { return items + size; }
+    const T *begin() const { return items; }
+    const T *end() const { return items + size; }
+
     /*
      * Removes the element at a specific position, shifting all following elements left.
      * Parameters: index - the position of the element to remove (0-based)
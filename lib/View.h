@@ -0,0 +1,205 @@
+#ifndef VIEW_H
+#define VIEW_H
+
+#include <type_traits>
+#include <utility>
+#include "Vector.h"
+
+/*
+ * Lazy views over a pair of forward iterators. A view holds no elements of its own: filter()
+ * and map() wrap the iterators, and nothing is read until the view is walked, so a caller can
+ * stream over a container, count matches, or copy out just the page it displays.
+ * A view only stays valid while the container it was taken from is unchanged.
+ */
+
+/// Forward iterator over the integers [first, last), for walking rows or positions by index
+class CountingIterator
+{
+private:
+    int value;
+
+public:
+    explicit CountingIterator(int value) : value(value) {}
+
+    int operator*() const { return value; }
+
+    CountingIterator &operator++()
+    {
+        value++;
+        return *this;
+    }
+
+    bool operator==(const CountingIterator &other) const { return value == other.value; }
+    bool operator!=(const CountingIterator &other) const { return value != other.value; }
+};
+
+/// Forward iterator that skips the elements a predicate rejects
+template <typename It, typename Predicate>
+class FilterIterator
+{
+private:
+    It current;
+    It last;
+    Predicate keep;
+
+    void skipRejected()
+    {
+        while (current != last && !keep(*current))
+        {
+            ++current;
+        }
+    }
+
+public:
+    FilterIterator(It current, It last, Predicate keep)
+        : current(current), last(last), keep(keep)
+    {
+        skipRejected();
+    }
+
+    decltype(*std::declval<const It &>()) operator*() const { return *current; }
+
+    FilterIterator &operator++()
+    {
+        ++current;
+        skipRejected();
+        return *this;
+    }
+
+    bool operator==(const FilterIterator &other) const { return current == other.current; }
+    bool operator!=(const FilterIterator &other) const { return current != other.current; }
+};
+
+/// Forward iterator that applies a function to each element as it is read
+template <typename It, typename Transform>
+class MapIterator
+{
+private:
+    It current;
+    Transform transform;
+
+public:
+    MapIterator(It current, Transform transform)
+        : current(current), transform(transform) {}
+
+    decltype(std::declval<const Transform &>()(*std::declval<const It &>())) operator*() const
+    {
+        return transform(*current);
+    }
+
+    MapIterator &operator++()
+    {
+        ++current;
+        return *this;
+    }
+
+    bool operator==(const MapIterator &other) const { return current == other.current; }
+    bool operator!=(const MapIterator &other) const { return current != other.current; }
+};
+
+template <typename It>
+class View
+{
+private:
+    It first;
+    It last;
+
+public:
+    typedef typename std::decay<decltype(*std::declval<const It &>())>::type ValueType;
+
+    View(It first, It last) : first(first), last(last) {}
+
+    It begin() const { return first; }
+    It end() const { return last; }
+
+    bool isEmpty() const
+    {
+        return !(first != last);
+    }
+
+    /*
+     * Narrows the view to the elements a predicate accepts, without reading anything yet.
+     * Parameters: keep - a function returning true for elements to keep
+     * Returns: the filtered view
+     */
+    template <typename Predicate>
+    View<FilterIterator<It, Predicate>> filter(Predicate keep) const
+    {
+        return View<FilterIterator<It, Predicate>>(FilterIterator<It, Predicate>(first, last, keep),
+                                                   FilterIterator<It, Predicate>(last, last, keep));
+    }
+
+    /*
+     * Transforms each element as it is read, without reading anything yet.
+     * Parameters: transform - a function applied to each element
+     * Returns: the transformed view
+     */
+    template <typename Transform>
+    View<MapIterator<It, Transform>> map(Transform transform) const
+    {
+        return View<MapIterator<It, Transform>>(MapIterator<It, Transform>(first, transform),
+                                                MapIterator<It, Transform>(last, transform));
+    }
+
+    /*
+     * Counts the elements by walking the view, without copying any of them.
+     * Parameters: none
+     * Returns: the number of elements
+     */
+    int count() const
+    {
+        int total = 0;
+        for (It it = first; it != last; ++it)
+        {
+            total++;
+        }
+        return total;
+    }
+
+    /*
+     * Copies a window of the view, e.g. the page being displayed.
+     * Parameters: start - number of elements to skip, limit - most elements to copy
+     * Returns: a Vector with at most limit elements
+     */
+    Vector<ValueType> slice(int start, int limit) const
+    {
+        Vector<ValueType> result(limit > 0 ? limit : 1);
+        It it = first;
+        for (int skipped = 0; skipped < start && it != last; skipped++)
+        {
+            ++it;
+        }
+        for (; it != last && result.getSize() < limit; ++it)
+        {
+            result.append(*it);
+        }
+        return result;
+    }
+
+    /*
+     * Copies every element of the view.
+     * Parameters: none
+     * Returns: a Vector of the elements, in view order
+     */
+    Vector<ValueType> toVector() const
+    {
+        Vector<ValueType> result;
+        for (It it = first; it != last; ++it)
+        {
+            result.append(*it);
+        }
+        return result;
+    }
+};
+
+/*
+ * Creates a view of the integers [first, last).
+ * Parameters: first - the first value, last - one past the last value
+ * Returns: the view
+ */
+inline View<CountingIterator> indexRange(int first, int last)
+{
+    return View<CountingIterator>(CountingIterator(first), CountingIterator(last > first ? last : first));
+}
+
+#endif
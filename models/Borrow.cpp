@@ -14,18 +14,20 @@ Borrow Borrow::fromCSVRow(const Vector<std::string>& row)
     borrow.memberId = atoi(row.get(1).c_str());
     borrow.gameId = atoi(row.get(2).c_str());
     int offset = (row.getSize() >= 6) ? 1 : 0;
-    borrow.dateBorrowed = trim(row.get(3 + offset));
-    borrow.dateReturned = trim(row.get(4 + offset));
+    // Dates are only parsed and formatted here; "N/A" or an empty field means not returned
+    DateHelper::parseTimestamp(trim(row.get(3 + offset)), borrow.dateBorrowed);
+    if (!DateHelper::parseTimestamp(trim(row.get(4 + offset)), borrow.dateReturned))
+    {
+        borrow.dateReturned = DateHelper::NO_TIMESTAMP;
+    }
     return borrow;
 }
 
-Vector<std::string> Borrow::toCSVRow(const Borrow& borrow)
+void Borrow::writeCSVRow(CSVWriter &writer, const Borrow &borrow)
 {
-    Vector<std::string> row;
-    row.append(std::to_string(borrow.borrowId));
-    row.append(std::to_string(borrow.memberId));
-    row.append(std::to_string(borrow.gameId));
-    row.append(borrow.dateBorrowed);
-    row.append(borrow.dateReturned);
-    return row;
+    writer.writeField(borrow.borrowId);
+    writer.writeField(borrow.memberId);
+    writer.writeField(borrow.gameId);
+    writer.writeField(DateHelper::formatTimestamp(borrow.dateBorrowed));
+    writer.writeField(DateHelper::formatTimestamp(borrow.dateReturned));
 }
@@ -3,6 +3,9 @@
 
 #include <string>
 #include "../lib/Vector.h"
+#include "../utils/Date.h"
+
+class CSVWriter;
 
 /// Borrow record data structure
 struct Borrow
@@ -10,19 +13,21 @@ struct Borrow
     int borrowId;
     int memberId;
     int gameId;
-    std::string dateBorrowed;
-    std::string dateReturned;
+    DateHelper::Timestamp dateBorrowed;
+    DateHelper::Timestamp dateReturned; // DateHelper::NO_TIMESTAMP while the game is still borrowed
 
-    Borrow() : borrowId(0), memberId(0), gameId(0), dateBorrowed(""), dateReturned("") {}
+    Borrow() : borrowId(0), memberId(0), gameId(0), dateBorrowed(0), dateReturned(DateHelper::NO_TIMESTAMP) {}
 
-    Borrow(int borrowId, int memberId, int gameId, const std::string &dateBorrowed,
-           const std::string &dateReturned = "N/A")
+    Borrow(int borrowId, int memberId, int gameId, DateHelper::Timestamp dateBorrowed,
+           DateHelper::Timestamp dateReturned = DateHelper::NO_TIMESTAMP)
         : borrowId(borrowId), memberId(memberId), gameId(gameId),
           dateBorrowed(dateBorrowed), dateReturned(dateReturned) {}
 
+    bool isReturned() const { return dateReturned != DateHelper::NO_TIMESTAMP; }
+
     static std::string csvHeader();
     static Borrow fromCSVRow(const Vector<std::string> &row);
-    static Vector<std::string> toCSVRow(const Borrow &borrow);
+    static void writeCSVRow(CSVWriter &writer, const Borrow &borrow);
 };
 
 #endif
@@ -11,7 +11,7 @@ Game Game::fromCSVRow(const Vector<std::string> &row)
 {
     Game game;
     game.id = atoi(row.get(0).c_str());
-    game.name = trim(row.get(1));
+    game.name = StringPool::global().intern(trim(row.get(1)));
     game.minPlayers = atoi(row.get(2).c_str());
     game.maxPlayers = atoi(row.get(3).c_str());
     game.maxPlaytime = atoi(row.get(4).c_str());
@@ -21,16 +21,14 @@ Game Game::fromCSVRow(const Vector<std::string> &row)
     return game;
 }
 
-Vector<std::string> Game::toCSVRow(const Game &game)
+void Game::writeCSVRow(CSVWriter &writer, const Game &game)
 {
-    Vector<std::string> row;
-    row.append(std::to_string(game.id));
-    row.append(game.name);
-    row.append(std::to_string(game.minPlayers));
-    row.append(std::to_string(game.maxPlayers));
-    row.append(std::to_string(game.maxPlaytime));
-    row.append(std::to_string(game.minPlaytime));
-    row.append(std::to_string(game.yearPublished));
-    row.append(std::to_string(game.isDeleted ? 1 : 0));
-    return row;
+    writer.writeField(game.id);
+    writer.writeField(game.name.view());
+    writer.writeField(game.minPlayers);
+    writer.writeField(game.maxPlayers);
+    writer.writeField(game.maxPlaytime);
+    writer.writeField(game.minPlaytime);
+    writer.writeField(game.yearPublished);
+    writer.writeField(game.isDeleted ? 1 : 0);
 }
@@ -3,12 +3,15 @@
 
 #include <string>
 #include "../lib/Vector.h"
+#include "../lib/StringPool.h"
+
+class CSVWriter;
 
 /// Game data structure
 struct Game
 {
     int id;
-    std::string name;
+    StringHandle name; // interned, since copies of a game share their name
     int minPlayers;
     int maxPlayers;
     int minPlaytime;
@@ -16,10 +19,10 @@ struct Game
     int yearPublished;
     bool isDeleted;
 
-    Game() : id(0), name(""), minPlayers(0), maxPlayers(0),
+    Game() : id(0), name(), minPlayers(0), maxPlayers(0),
              minPlaytime(0), maxPlaytime(0), yearPublished(0), isDeleted(false) {}
 
-    Game(int id, const std::string &name, int minPlayers, int maxPlayers,
+    Game(int id, StringHandle name, int minPlayers, int maxPlayers,
          int minPlaytime, int maxPlaytime, int yearPublished, bool isDeleted = false)
         : id(id), name(name), minPlayers(minPlayers), maxPlayers(maxPlayers),
           minPlaytime(minPlaytime), maxPlaytime(maxPlaytime),
@@ -27,7 +30,7 @@ struct Game
 
     static std::string csvHeader();
     static Game fromCSVRow(const Vector<std::string> &row);
-    static Vector<std::string> toCSVRow(const Game &game);
+    static void writeCSVRow(CSVWriter &writer, const Game &game);
 };
 
 #endif
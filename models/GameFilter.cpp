@@ -0,0 +1,97 @@
+#include "GameFilter.h"
+#include <climits>
+
+// Bucket lower bounds; small values get their own bucket since they are the common query values
+static const int PLAYER_BOUNDS[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 16, 21, 31, 51, 101};
+static const int PLAYTIME_BOUNDS[] = {0, 10, 15, 20, 30, 45, 60, 75, 90, 120, 150, 180, 240, 360, 600};
+static const int YEAR_BOUNDS[] = {0, 1900, 1950, 1970, 1980, 1990, 1995, 2000, 2002, 2004, 2006, 2008,
+                                  2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                                  2020, 2021, 2022, 2023, 2024, 2025, 2026, 2030};
+
+GameFilter::GameFilter(const GameTable &games)
+    : games(games),
+      minPlayersIndex(PLAYER_BOUNDS, (int)(sizeof(PLAYER_BOUNDS) / sizeof(int))),
+      maxPlayersIndex(PLAYER_BOUNDS, (int)(sizeof(PLAYER_BOUNDS) / sizeof(int))),
+      maxPlaytimeIndex(PLAYTIME_BOUNDS, (int)(sizeof(PLAYTIME_BOUNDS) / sizeof(int))),
+      yearIndex(YEAR_BOUNDS, (int)(sizeof(YEAR_BOUNDS) / sizeof(int)))
+{
+}
+
+void GameFilter::rebuild()
+{
+    activeRows.clear();
+    minPlayersIndex.clear();
+    maxPlayersIndex.clear();
+    maxPlaytimeIndex.clear();
+    yearIndex.clear();
+    for (int row = 0; row < games.getSize(); row++)
+    {
+        addRow(row);
+    }
+}
+
+void GameFilter::addRow(int row)
+{
+    GameView game = games.view(row);
+    if (!game.isDeleted())
+    {
+        activeRows.add(row);
+    }
+    minPlayersIndex.add(row, game.minPlayers());
+    maxPlayersIndex.add(row, game.maxPlayers());
+    maxPlaytimeIndex.add(row, game.maxPlaytime());
+    yearIndex.add(row, game.yearPublished());
+}
+
+void GameFilter::removeRow(int row)
+{
+    GameView game = games.view(row);
+    activeRows.remove(row);
+    minPlayersIndex.remove(row, game.minPlayers());
+    maxPlayersIndex.remove(row, game.maxPlayers());
+    maxPlaytimeIndex.remove(row, game.maxPlaytime());
+    yearIndex.remove(row, game.yearPublished());
+}
+
+Bitmap GameFilter::query(const GameQuery &query) const
+{
+    Bitmap result = activeRows;
+    if (query.players > 0)
+    {
+        result = result.intersect(matchPlayers(query.players));
+    }
+    if (query.maxPlaytime > 0)
+    {
+        result = result.intersect(matchPlaytimeAtMost(query.maxPlaytime));
+    }
+    if (query.publishedAfter > 0)
+    {
+        result = result.intersect(matchPublishedAfter(query.publishedAfter));
+    }
+    return result;
+}
+
+Bitmap GameFilter::matchPlayers(int playerCount) const
+{
+    Bitmap minFits = minPlayersIndex.range(INT_MIN, playerCount, [&](int row)
+                                           { return games.view(row).minPlayers(); });
+    Bitmap maxFits = maxPlayersIndex.range(playerCount, INT_MAX, [&](int row)
+                                           { return games.view(row).maxPlayers(); });
+    return minFits.intersect(maxFits);
+}
+
+Bitmap GameFilter::matchPlaytimeAtMost(int minutes) const
+{
+    return maxPlaytimeIndex.range(INT_MIN, minutes, [&](int row)
+                                  { return games.view(row).maxPlaytime(); });
+}
+
+Bitmap GameFilter::matchPublishedAfter(int year) const
+{
+    if (year == INT_MAX)
+    {
+        return Bitmap();
+    }
+    return yearIndex.range(year + 1, INT_MAX, [&](int row)
+                           { return games.view(row).yearPublished(); });
+}
@@ -0,0 +1,86 @@
+#ifndef GAMEFILTER_H
+#define GAMEFILTER_H
+
+#include "GameTable.h"
+#include "../lib/Bitmap.h"
+
+/// Optional criteria for filtering the game catalogue; a value of 0 means "any"
+struct GameQuery
+{
+    int players;        // the game must support this many players
+    int maxPlaytime;    // the game's longest playtime must fit within this many minutes
+    int publishedAfter; // the game must have been published after this year
+
+    GameQuery() : players(0), maxPlaytime(0), publishedAfter(0) {}
+};
+
+/*
+ * Bitmap indexes over the rows of a GameTable for multi-attribute filtering.
+ * Each filterable column has a bucketed range index; a query turns every criterion into a
+ * bitmap of matching rows and ANDs them together with the bitmap of non-deleted rows,
+ * so no Game is materialised until the caller displays it.
+ */
+class GameFilter
+{
+private:
+    const GameTable &games;
+    Bitmap activeRows;
+    BitmapRangeIndex minPlayersIndex;
+    BitmapRangeIndex maxPlayersIndex;
+    BitmapRangeIndex maxPlaytimeIndex;
+    BitmapRangeIndex yearIndex;
+
+public:
+    GameFilter(const GameTable &games);
+
+    /*
+     * Re-indexes every row of the table.
+     * Parameters: none
+     * Returns: nothing
+     */
+    void rebuild();
+
+    /*
+     * Indexes one row using its current column values.
+     * Parameters: row - the row index
+     * Returns: nothing
+     */
+    void addRow(int row);
+
+    /*
+     * Removes one row from every index. Must be called before the row's values change.
+     * Parameters: row - the row index
+     * Returns: nothing
+     */
+    void removeRow(int row);
+
+    /*
+     * Finds the non-deleted rows matching every criterion of a query.
+     * Parameters: query - the criteria to apply
+     * Returns: a bitmap of the matching rows
+     */
+    Bitmap query(const GameQuery &query) const;
+
+    /*
+     * Finds the rows supporting a player count (minPlayers <= count <= maxPlayers).
+     * Parameters: playerCount - the number of players
+     * Returns: a bitmap of the matching rows, including deleted ones
+     */
+    Bitmap matchPlayers(int playerCount) const;
+
+    /*
+     * Finds the rows whose maximum playtime fits a time budget.
+     * Parameters: minutes - the time budget in minutes
+     * Returns: a bitmap of the matching rows, including deleted ones
+     */
+    Bitmap matchPlaytimeAtMost(int minutes) const;
+
+    /*
+     * Finds the rows published after a year.
+     * Parameters: year - the year, exclusive
+     * Returns: a bitmap of the matching rows, including deleted ones
+     */
+    Bitmap matchPublishedAfter(int year) const;
+};
+
+#endif
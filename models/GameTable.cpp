@@ -0,0 +1,139 @@
+#include "GameTable.h"
+#include <cstring>
+#include <stdexcept>
+
+Game GameView::toGame() const
+{
+    return Game(id(), name(), minPlayers(), maxPlayers(),
+                minPlaytime(), maxPlaytime(), yearPublished(), isDeleted());
+}
+
+GameTable::GameTable() : maxId(0) {}
+
+void GameTable::insert(int id, const Game &game)
+{
+    int row = findRow(id);
+    if (row == -1)
+    {
+        row = ids.getSize();
+        ids.append(id);
+        minPlayers.append(0);
+        maxPlayers.append(0);
+        minPlaytime.append(0);
+        maxPlaytime.append(0);
+        yearPublished.append(0);
+        deleted.append(0);
+        names.append(StringHandle());
+        rowsById.insert(id, row);
+        if (row == 0 || id > maxId)
+        {
+            maxId = id;
+        }
+    }
+
+    names[row] = game.name;
+    minPlayers[row] = game.minPlayers;
+    maxPlayers[row] = game.maxPlayers;
+    minPlaytime[row] = game.minPlaytime;
+    maxPlaytime[row] = game.maxPlaytime;
+    yearPublished[row] = game.yearPublished;
+    deleted[row] = game.isDeleted ? 1 : 0;
+}
+
+bool GameTable::markDeleted(int id)
+{
+    int row = findRow(id);
+    if (row == -1)
+    {
+        return false;
+    }
+    deleted[row] = 1;
+    return true;
+}
+
+bool GameTable::exists(int id) const
+{
+    return rowsById.exists(id);
+}
+
+Game GameTable::get(int id) const
+{
+    int row = findRow(id);
+    if (row == -1)
+    {
+        throw std::runtime_error("Key not found in game table");
+    }
+    return view(row).toGame();
+}
+
+int GameTable::findRow(int id) const
+{
+    return rowsById.exists(id) ? rowsById.get(id) : -1;
+}
+
+GameView GameTable::view(int row) const
+{
+    return GameView(this, row);
+}
+
+int GameTable::compareNames(int rowA, int rowB) const
+{
+    if (names[rowA] == names[rowB])
+    {
+        return 0;
+    }
+    return strcmp(names[rowA].c_str(), names[rowB].c_str());
+}
+
+Vector<int> GameTable::findRowsForPlayerCount(int playerCount) const
+{
+    const int *minP = minPlayers.data();
+    const int *maxP = maxPlayers.data();
+    const unsigned char *del = deleted.data();
+    return collectRows([=](int i)
+                       { return (minP[i] <= playerCount) & (playerCount <= maxP[i]) & (del[i] == 0); });
+}
+
+int GameTable::getSize() const
+{
+    return ids.getSize();
+}
+
+bool GameTable::isEmpty() const
+{
+    return ids.isEmpty();
+}
+
+int GameTable::maxKey() const
+{
+    return maxId;
+}
+
+void GameTable::clear()
+{
+    ids.clear();
+    minPlayers.clear();
+    maxPlayers.clear();
+    minPlaytime.clear();
+    maxPlaytime.clear();
+    yearPublished.clear();
+    deleted.clear();
+    names.clear();
+    rowsById.clear();
+    maxId = 0;
+}
+
+Vector<Game> GameTable::toVector() const
+{
+    Vector<Game> result;
+    for (int row = 0; row < ids.getSize(); row++)
+    {
+        result.append(view(row).toGame());
+    }
+    return result;
+}
+
+void GameTable::forEach(std::function<void(const int &, const Game &)> func) const
+{
+    forEach<std::function<void(const int &, const Game &)>>(func);
+}
@@ -0,0 +1,204 @@
+#ifndef GAMETABLE_H
+#define GAMETABLE_H
+
+#include <string>
+#include <functional>
+#include "Game.h"
+#include "../lib/Vector.h"
+#include "../lib/Dictionary.h"
+
+class GameTable;
+
+/// Read-only view of one GameTable row; valid until the table is next modified
+struct GameView
+{
+    const GameTable *table;
+    int row;
+
+    GameView(const GameTable *table, int row) : table(table), row(row) {}
+
+    int id() const;
+    StringHandle name() const;
+    int minPlayers() const;
+    int maxPlayers() const;
+    int minPlaytime() const;
+    int maxPlaytime() const;
+    int yearPublished() const;
+    bool isDeleted() const;
+    Game toGame() const;
+};
+
+/*
+ * Columnar (struct-of-arrays) storage for the game catalogue.
+ * Every Game field lives in its own contiguous array indexed by row, and names are stored
+ * as interned handles, so scans only touch the columns they filter on.
+ * Rows are never removed: removing a game only sets its isDeleted flag.
+ */
+class GameTable
+{
+private:
+    Vector<int> ids;
+    Vector<int> minPlayers;
+    Vector<int> maxPlayers;
+    Vector<int> minPlaytime;
+    Vector<int> maxPlaytime;
+    Vector<int> yearPublished;
+    Vector<unsigned char> deleted;
+    Vector<StringHandle> names;
+    Dictionary<int, int, ArenaAllocator> rowsById; // rows are never removed, so ids are never erased
+    int maxId;
+
+    static const int SCAN_BLOCK = 256;
+
+    /*
+     * Collects the rows matching a predicate.
+     * The predicate is first evaluated branch-free over a block of rows into a match mask
+     * (a loop compilers can vectorise), then the matching row numbers are compacted.
+     */
+    template <typename Predicate>
+    Vector<int> collectRows(Predicate matches) const
+    {
+        Vector<int> rows;
+        unsigned char mask[SCAN_BLOCK];
+        int size = ids.getSize();
+        for (int start = 0; start < size; start += SCAN_BLOCK)
+        {
+            int count = size - start < SCAN_BLOCK ? size - start : SCAN_BLOCK;
+            for (int i = 0; i < count; i++)
+            {
+                mask[i] = (unsigned char)matches(start + i);
+            }
+            for (int i = 0; i < count; i++)
+            {
+                if (mask[i])
+                {
+                    rows.append(start + i);
+                }
+            }
+        }
+        return rows;
+    }
+
+    friend struct GameView;
+
+public:
+    GameTable();
+
+    /*
+     * Stores a game. Appends a new row, or overwrites the existing row if the id is already present.
+     * Parameters: id - the game id, game - the game data
+     * Returns: nothing
+     */
+    void insert(int id, const Game &game);
+
+    /*
+     * Marks a game as deleted without removing its row.
+     * Parameters: id - the game id
+     * Returns: true if the game exists, false otherwise
+     */
+    bool markDeleted(int id);
+
+    /*
+     * Checks whether a game id is stored in the table.
+     * Parameters: id - the game id
+     * Returns: true if the id exists, false otherwise
+     */
+    bool exists(int id) const;
+
+    /*
+     * Materialises a game as a Game struct. Throws runtime_error if the id is not found.
+     * Parameters: id - the game id
+     * Returns: a copy of the game
+     */
+    Game get(int id) const;
+
+    /*
+     * Finds the row a game is stored in.
+     * Parameters: id - the game id
+     * Returns: the row index, or -1 if the id is not found
+     */
+    int findRow(int id) const;
+
+    /*
+     * Returns a read-only view of a row.
+     * Parameters: row - the row index (0 to getSize() - 1)
+     * Returns: a view over the row's columns
+     */
+    GameView view(int row) const;
+
+    /*
+     * Compares the names of two rows.
+     * Parameters: rowA, rowB - the row indices to compare
+     * Returns: negative, 0 or positive as rowA's name sorts before, equal to or after rowB's
+     */
+    int compareNames(int rowA, int rowB) const;
+
+    /*
+     * Finds every non-deleted game that supports a player count, scanning only the player and deleted columns.
+     * Parameters: playerCount - the number of players
+     * Returns: the matching row indices in row order
+     */
+    Vector<int> findRowsForPlayerCount(int playerCount) const;
+
+    int getSize() const;
+    bool isEmpty() const;
+    int maxKey() const;
+    void clear();
+
+    /*
+     * Materialises every game into a Vector, in row order.
+     * Parameters: none
+     * Returns: a Vector containing a copy of every game
+     */
+    Vector<Game> toVector() const;
+
+    /*
+     * Calls a function for each stored game, in row order.
+     * Takes any callable, so the function body is inlined into the loop.
+     * Parameters: func - a function that takes a game id and the game
+     * Returns: nothing
+     */
+    template <typename Func>
+    void forEach(Func func) const
+    {
+        for (int row = 0; row < ids.getSize(); row++)
+        {
+            func(ids[row], view(row).toGame());
+        }
+    }
+
+    /*
+     * std::function version of forEach, for call sites that already hold one.
+     * Parameters: func - a function that takes a game id and the game
+     * Returns: nothing
+     */
+    void forEach(std::function<void(const int &, const Game &)> func) const;
+};
+
+/// Orders GameTable rows by name, breaking ties by row so the order is total.
+/// A named comparator type, so sorts and lazy sorted views over rows call it directly.
+struct GameRowOrder
+{
+    const GameTable *table;
+
+    GameRowOrder(const GameTable *table) : table(table) {}
+
+    int operator()(const int &rowA, const int &rowB) const;
+};
+
+inline int GameView::id() const { return table->ids[row]; }
+inline StringHandle GameView::name() const { return table->names[row]; }
+inline int GameView::minPlayers() const { return table->minPlayers[row]; }
+inline int GameView::maxPlayers() const { return table->maxPlayers[row]; }
+inline int GameView::minPlaytime() const { return table->minPlaytime[row]; }
+inline int GameView::maxPlaytime() const { return table->maxPlaytime[row]; }
+inline int GameView::yearPublished() const { return table->yearPublished[row]; }
+inline bool GameView::isDeleted() const { return table->deleted[row] != 0; }
+
+inline int GameRowOrder::operator()(const int &rowA, const int &rowB) const
+{
+    int nameCompare = table->compareNames(rowA, rowB);
+    return nameCompare != 0 ? nameCompare : rowA - rowB;
+}
+
+#endif
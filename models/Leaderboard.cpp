@@ -0,0 +1,77 @@
+#include "Leaderboard.h"
+#include <cstring>
+
+int LeaderboardEntryOrder::operator()(const LeaderboardEntry &a, const LeaderboardEntry &b) const
+{
+    if (a.score != b.score)
+    {
+        return a.score > b.score ? -1 : 1;
+    }
+    if (a.title == b.title)
+    {
+        return 0;
+    }
+    return strcmp(a.title.c_str(), b.title.c_str());
+}
+
+Leaderboard::Leaderboard() : ranking(LeaderboardEntryOrder()) {}
+
+void Leaderboard::set(StringHandle title, double score)
+{
+    remove(title);
+    scores.insert(title, score);
+    ranking.insert(LeaderboardEntry(title, score));
+}
+
+void Leaderboard::remove(StringHandle title)
+{
+    if (scores.exists(title))
+    {
+        ranking.remove(LeaderboardEntry(title, scores.get(title)));
+        scores.remove(title);
+    }
+}
+
+LeaderboardEntry Leaderboard::at(int rank) const
+{
+    return ranking.kth(rank);
+}
+
+int Leaderboard::getSize() const
+{
+    return ranking.getSize();
+}
+
+void Leaderboard::clear()
+{
+    scores.clear();
+    ranking.clear();
+}
+
+SlidingWindowCounter::SlidingWindowCounter(int windowLength)
+    : head(0), windowLength(windowLength) {}
+
+int SlidingWindowCounter::record(StringHandle key, int time)
+{
+    events.append(Event(time, key));
+    int count = counts.exists(key) ? counts.get(key) + 1 : 1;
+    counts.insert(key, count);
+    return count;
+}
+
+int SlidingWindowCounter::countOf(StringHandle key) const
+{
+    return counts.exists(key) ? counts.get(key) : 0;
+}
+
+int SlidingWindowCounter::getWindowLength() const
+{
+    return windowLength;
+}
+
+void SlidingWindowCounter::clear()
+{
+    events.clear();
+    head = 0;
+    counts.clear();
+}
@@ -0,0 +1,149 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <string>
+#include "../lib/Vector.h"
+#include "../lib/Dictionary.h"
+#include "../lib/StringPool.h"
+#include "../lib/OrderStatisticTree.h"
+
+/// One ranked title on a leaderboard
+struct LeaderboardEntry
+{
+    StringHandle title;
+    double score;
+
+    LeaderboardEntry() : title(), score(0.0) {}
+    LeaderboardEntry(StringHandle title, double score) : title(title), score(score) {}
+};
+
+/// Ranking order of leaderboard entries: higher score first, then title alphabetically
+struct LeaderboardEntryOrder
+{
+    int operator()(const LeaderboardEntry &a, const LeaderboardEntry &b) const;
+};
+
+/*
+ * Game titles ranked by a score, highest first (ties broken by title).
+ * Scores are changed one title at a time and the ranking is kept in an order-statistic tree,
+ * so an update is O(log n) and any page of the ranking is read with k-th element lookups.
+ */
+class Leaderboard
+{
+private:
+    Dictionary<StringHandle, double> scores;
+    OrderStatisticTree<LeaderboardEntry, LeaderboardEntryOrder> ranking;
+
+public:
+    Leaderboard();
+
+    /*
+     * Sets the score of a title, adding it to the ranking if needed.
+     * Parameters: title - the game title, score - the new score
+     * Returns: nothing
+     */
+    void set(StringHandle title, double score);
+
+    /*
+     * Removes a title from the ranking.
+     * Parameters: title - the game title
+     * Returns: nothing
+     */
+    void remove(StringHandle title);
+
+    /*
+     * Retrieves the entry at a position in the ranking.
+     * Parameters: rank - the 0-based position (0 is the highest score)
+     * Returns: the entry at that position, or throws out_of_range if rank is invalid
+     */
+    LeaderboardEntry at(int rank) const;
+
+    int getSize() const;
+    void clear();
+};
+
+/*
+ * Counts events per key over a sliding time window.
+ * Events must be recorded in non-decreasing time order; they are kept in a FIFO queue and
+ * expired from the front as time advances, so every event is added and removed exactly once.
+ */
+class SlidingWindowCounter
+{
+private:
+    struct Event
+    {
+        int time;
+        StringHandle key;
+
+        Event() : time(0), key() {}
+        Event(int time, StringHandle key) : time(time), key(key) {}
+    };
+
+    Vector<Event> events;
+    int head;
+    int windowLength;
+    Dictionary<StringHandle, int> counts;
+
+public:
+    SlidingWindowCounter(int windowLength);
+
+    /*
+     * Records an event.
+     * Parameters: key - what the event is counted under, time - when it happened
+     * Returns: the key's count within the window, including this event
+     */
+    int record(StringHandle key, int time);
+
+    /*
+     * Drops every event older than the window ending at now.
+     * Parameters: now - the current time,
+     *             onChange - called with each affected key and its new count
+     * Returns: nothing
+     */
+    template <typename OnChange>
+    void expire(int now, OnChange onChange);
+
+    /*
+     * Returns how many events a key has within the window, as of the last expire().
+     * Parameters: key - the key to look up
+     * Returns: the key's count, or 0 if it has none
+     */
+    int countOf(StringHandle key) const;
+
+    int getWindowLength() const;
+    void clear();
+};
+
+template <typename OnChange>
+void SlidingWindowCounter::expire(int now, OnChange onChange)
+{
+    while (head < events.getSize() && events[head].time <= now - windowLength)
+    {
+        StringHandle key = events[head].key;
+        int count = counts.get(key) - 1;
+        if (count == 0)
+        {
+            counts.remove(key);
+        }
+        else
+        {
+            counts.insert(key, count);
+        }
+        onChange(key, count);
+        head++;
+    }
+
+    // Compact once the expired prefix dominates the queue
+    if (head > 64 && head * 2 > events.getSize())
+    {
+        Vector<Event> live(events.getSize() - head + 1);
+        for (int i = head; i < events.getSize(); i++)
+        {
+            live.append(events[i]);
+        }
+        events = live;
+        head = 0;
+    }
+}
+
+#endif
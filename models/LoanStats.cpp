@@ -0,0 +1,34 @@
+#include "LoanStats.h"
+
+LoanStats::LoanStats()
+    : totalLoans(0), returnedLoans(0), returnedMinutes(0),
+      lastBorrowed(DateHelper::NO_TIMESTAMP), lastBorrowerId(-1) {}
+
+void LoanStats::recordBorrow(const Borrow &borrow)
+{
+    totalLoans++;
+    if (lastBorrowed == DateHelper::NO_TIMESTAMP || borrow.dateBorrowed >= lastBorrowed)
+    {
+        lastBorrowed = borrow.dateBorrowed;
+        lastBorrowerId = borrow.memberId;
+    }
+    if (borrow.isReturned())
+    {
+        recordReturn(borrow);
+    }
+}
+
+void LoanStats::recordReturn(const Borrow &borrow)
+{
+    returnedLoans++;
+    returnedMinutes += borrow.dateReturned - borrow.dateBorrowed;
+}
+
+float LoanStats::averageLoanDays() const
+{
+    if (returnedLoans == 0)
+    {
+        return 0.0f;
+    }
+    return (float)((double)returnedMinutes / returnedLoans / DateHelper::MINUTES_PER_DAY);
+}
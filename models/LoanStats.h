@@ -0,0 +1,39 @@
+#ifndef LOANSTATS_H
+#define LOANSTATS_H
+
+#include "Borrow.h"
+
+/// Running loan statistics for one game copy, updated one borrow or return at a time
+struct LoanStats
+{
+    int totalLoans;
+    int returnedLoans;
+    long long returnedMinutes; // total duration of all returned loans
+    DateHelper::Timestamp lastBorrowed;
+    int lastBorrowerId;
+
+    LoanStats();
+
+    /*
+     * Adds a loan to the statistics, counting its duration if it is already returned.
+     * Parameters: borrow - the borrow record
+     * Returns: nothing
+     */
+    void recordBorrow(const Borrow &borrow);
+
+    /*
+     * Counts the duration of a loan that has just been returned.
+     * Parameters: borrow - the borrow record, with its return date set
+     * Returns: nothing
+     */
+    void recordReturn(const Borrow &borrow);
+
+    /*
+     * Returns the mean duration of returned loans.
+     * Parameters: none
+     * Returns: the average loan length in days, or 0 if no loan has been returned
+     */
+    float averageLoanDays() const;
+};
+
+#endif
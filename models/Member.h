@@ -3,21 +3,24 @@
 
 #include <string>
 #include "../lib/Vector.h"
+#include "../lib/StringPool.h"
+
+class CSVWriter;
 
 /// Member data structure
 struct Member
 {
     int id;
-    std::string username;
+    StringHandle username; // interned
     bool isAdmin;
 
-    Member() : id(0), username(""), isAdmin(false) {}
-    Member(int id, const std::string& username, bool isAdmin) 
+    Member() : id(0), username(), isAdmin(false) {}
+    Member(int id, StringHandle username, bool isAdmin) 
         : id(id), username(username), isAdmin(isAdmin) {}
 
     static std::string csvHeader();
     static Member fromCSVRow(const Vector<std::string>& row);
-    static Vector<std::string> toCSVRow(const Member& member);
+    static void writeCSVRow(CSVWriter &writer, const Member &member);
 };
 
 #endif
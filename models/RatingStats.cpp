@@ -0,0 +1,57 @@
+#include "RatingStats.h"
+#include <cmath>
+
+RatingStats::RatingStats() : count(0), sum(0), sumOfSquares(0)
+{
+    for (int i = 0; i <= MAX_RATING - MIN_RATING; i++)
+    {
+        histogram[i] = 0;
+    }
+}
+
+void RatingStats::add(int rating)
+{
+    count++;
+    sum += rating;
+    sumOfSquares += (long long)rating * rating;
+    if (rating >= MIN_RATING && rating <= MAX_RATING)
+    {
+        histogram[rating - MIN_RATING]++;
+    }
+}
+
+void RatingStats::merge(const RatingStats &other)
+{
+    count += other.count;
+    sum += other.sum;
+    sumOfSquares += other.sumOfSquares;
+    for (int i = 0; i <= MAX_RATING - MIN_RATING; i++)
+    {
+        histogram[i] += other.histogram[i];
+    }
+}
+
+float RatingStats::average() const
+{
+    return count == 0 ? 0.0f : (float)sum / count;
+}
+
+float RatingStats::standardDeviation() const
+{
+    if (count == 0)
+    {
+        return 0.0f;
+    }
+    double mean = (double)sum / count;
+    double variance = (double)sumOfSquares / count - mean * mean;
+    return variance > 0 ? (float)std::sqrt(variance) : 0.0f;
+}
+
+int RatingStats::countOf(int rating) const
+{
+    if (rating < MIN_RATING || rating > MAX_RATING)
+    {
+        return 0;
+    }
+    return histogram[rating - MIN_RATING];
+}
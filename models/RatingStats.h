@@ -0,0 +1,53 @@
+#ifndef RATINGSTATS_H
+#define RATINGSTATS_H
+
+/// Running aggregate of review ratings, updated one review at a time
+struct RatingStats
+{
+    static const int MIN_RATING = 1;
+    static const int MAX_RATING = 5;
+
+    int count;
+    int sum;
+    long long sumOfSquares;
+    int histogram[MAX_RATING - MIN_RATING + 1];
+
+    RatingStats();
+
+    /*
+     * Adds one rating to the aggregate.
+     * Parameters: rating - the rating to add
+     * Returns: nothing
+     */
+    void add(int rating);
+
+    /*
+     * Adds every rating of another aggregate to this one.
+     * Parameters: other - the aggregate to fold in
+     * Returns: nothing
+     */
+    void merge(const RatingStats &other);
+
+    /*
+     * Returns the mean rating.
+     * Parameters: none
+     * Returns: the average, or 0 if there are no ratings
+     */
+    float average() const;
+
+    /*
+     * Returns the population standard deviation of the ratings.
+     * Parameters: none
+     * Returns: the standard deviation, or 0 if there are no ratings
+     */
+    float standardDeviation() const;
+
+    /*
+     * Returns how many ratings had a given value.
+     * Parameters: rating - the rating value (MIN_RATING to MAX_RATING)
+     * Returns: the number of ratings with that value, or 0 if it is out of range
+     */
+    int countOf(int rating) const;
+};
+
+#endif
@@ -18,13 +18,11 @@ Review Review::fromCSVRow(const Vector<std::string>& row)
     return review;
 }
 
-Vector<std::string> Review::toCSVRow(const Review& review)
+void Review::writeCSVRow(CSVWriter &writer, const Review &review)
 {
-    Vector<std::string> row;
-    row.append(std::to_string(review.reviewId));
-    row.append(std::to_string(review.userId));
-    row.append(std::to_string(review.gameId));
-    row.append(std::to_string(review.rating));
-    row.append(review.content);
-    return row;
+    writer.writeField(review.reviewId);
+    writer.writeField(review.userId);
+    writer.writeField(review.gameId);
+    writer.writeField(review.rating);
+    writer.writeField(review.content);
 }
@@ -4,6 +4,8 @@
 #include <string>
 #include "../lib/Vector.h"
 
+class CSVWriter;
+
 /// Review data structure
 struct Review
 {
@@ -21,7 +23,7 @@ struct Review
 
     static std::string csvHeader();
     static Review fromCSVRow(const Vector<std::string> &row);
-    static Vector<std::string> toCSVRow(const Review &review);
+    static void writeCSVRow(CSVWriter &writer, const Review &review);
 };
 
 #endif
@@ -0,0 +1,185 @@
+/*
+ * Torn-write harness for AtomicFile, CSVWriter and AppState::recoverInterruptedSaves.
+ * Each scenario interrupts a save at a different point and checks that the last complete
+ * version of the file is what the next load sees, and that no temporary file is left behind.
+ *
+ * Not part of NPTTGC.sln (it has its own main). Build it from the repository root together with
+ * every source file except NPTTGC.cpp, e.g. from a Developer Command Prompt:
+ *   cl /std:c++17 /EHsc /I. tests\TornWriteTest.cpp AppState.cpp Screen.cpp lib\*.cpp models\*.cpp utils\*.cpp
+ * It works in a scratch directory under the system temp directory and exits non-zero on failure.
+ */
+
+#include "AppState.h"
+#include "lib/AtomicFile.h"
+#include "lib/CSVHelper.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static int failures = 0;
+
+static void check(bool condition, const char *what)
+{
+    printf("  [%s] %s\n", condition ? "ok" : "FAIL", what);
+    if (!condition)
+    {
+        failures++;
+    }
+}
+
+static std::string readFile(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+static void writeFile(const std::string &path, const std::string &contents)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << contents;
+}
+
+static std::string gamesCSV()
+{
+    return Game::csvHeader() + "\n" +
+           "1,Azul,2,4,45,30,2017,0\n" +
+           "2,Carcassonne,2,5,45,30,2000,0\n";
+}
+
+static void writeDataFiles()
+{
+    writeFile("members.csv", Member::csvHeader() + "\n1,admin,1\n");
+    writeFile("games.csv", gamesCSV());
+    writeFile("borrows.csv", Borrow::csvHeader() + "\n");
+    writeFile("reviews.csv", Review::csvHeader() + "\n");
+}
+
+/*
+ * A save that fails partway through writing rows (the row writer throws after enough rows
+ * to spill the writer's buffer to disk) must leave the target untouched and remove its temp file.
+ */
+static void failedWriteKeepsTarget()
+{
+    printf("Failed write partway through a save\n");
+    writeFile("games.csv", gamesCSV());
+
+    Vector<int> rows;
+    for (int i = 0; i < 20000; i++)
+    {
+        rows.append(i);
+    }
+
+    bool threw = false;
+    try
+    {
+        saveToFile<int>("games.csv", Game::csvHeader(), rows, [](CSVWriter &writer, const int &row)
+                        {
+            if (row == 15000)
+            {
+                throw std::runtime_error("injected write failure");
+            }
+            writer.writeField(row);
+            writer.writeField("a row long enough to fill several buffers"); });
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+
+    check(threw, "the injected failure interrupted the save");
+    check(readFile("games.csv") == gamesCSV(), "games.csv still holds the previous version");
+    check(!fs::exists(AtomicFile::tempPathFor("games.csv")), "the partial temp file was removed");
+}
+
+/*
+ * A commit whose final rename fails (the target is a directory) must report failure,
+ * leave the target alone and remove the temp file.
+ */
+static void failedRenameKeepsTarget()
+{
+    printf("Failed rename at commit\n");
+    fs::create_directory("blocked.csv");
+
+    AtomicFile file("blocked.csv");
+    check(file.isOpen(), "the temp file was opened");
+    fputs("new contents\n", file.get());
+
+    check(!file.commit(), "commit reported the failed rename");
+    check(fs::is_directory("blocked.csv"), "the target was left untouched");
+    check(!fs::exists(AtomicFile::tempPathFor("blocked.csv")), "the temp file was removed");
+
+    fs::remove("blocked.csv");
+}
+
+/*
+ * A crash after the temp files were written but before they were renamed leaves them on disk.
+ * The next load must discard them, load the last complete CSVs, and rebuild the snapshot.
+ */
+static void staleTempFilesAreRecovered()
+{
+    printf("Crash between writing and renaming\n");
+    writeDataFiles();
+    writeFile(AtomicFile::tempPathFor("games.csv"), Game::csvHeader() + "\n3,Half a ro");
+    writeFile(AtomicFile::tempPathFor("reviews.csv"), "");
+    writeFile(AtomicFile::tempPathFor("npttgc.snapshot"), "not a snapshot");
+
+    AppState state;
+    state.loadData();
+
+    check(!fs::exists(AtomicFile::tempPathFor("games.csv")), "games.csv.tmp was discarded");
+    check(!fs::exists(AtomicFile::tempPathFor("reviews.csv")), "reviews.csv.tmp was discarded");
+    check(!fs::exists(AtomicFile::tempPathFor("npttgc.snapshot")), "npttgc.snapshot.tmp was discarded");
+    check(readFile("games.csv") == gamesCSV(), "games.csv still holds the last complete version");
+    check(state.games.getSize() == 2, "both complete games were loaded");
+    check(!state.games.exists(3), "nothing from the torn temp file was loaded");
+    check(fs::exists("npttgc.snapshot"), "a fresh snapshot was written");
+}
+
+/*
+ * A stale snapshot temp file next to a valid snapshot must not stop the snapshot from loading.
+ */
+static void staleSnapshotTempKeepsSnapshot()
+{
+    printf("Crash while replacing the snapshot\n");
+    std::string snapshot = readFile("npttgc.snapshot");
+    writeFile(AtomicFile::tempPathFor("npttgc.snapshot"), snapshot.substr(0, snapshot.size() / 2));
+
+    AppState state;
+    state.loadData();
+
+    check(!fs::exists(AtomicFile::tempPathFor("npttgc.snapshot")), "npttgc.snapshot.tmp was discarded");
+    check(readFile("npttgc.snapshot") == snapshot, "the complete snapshot was kept");
+    check(state.games.getSize() == 2, "the games were loaded");
+}
+
+int main()
+{
+    fs::path scratch = fs::temp_directory_path() / "npttgc_torn_write_test";
+    fs::remove_all(scratch);
+    fs::create_directories(scratch);
+    fs::path previous = fs::current_path();
+    fs::current_path(scratch);
+
+    failedWriteKeepsTarget();
+    failedRenameKeepsTarget();
+    staleTempFilesAreRecovered();
+    staleSnapshotTempKeepsSnapshot();
+
+    fs::current_path(previous);
+    fs::remove_all(scratch);
+
+    if (failures > 0)
+    {
+        printf("%d check(s) failed.\n", failures);
+        return 1;
+    }
+    printf("All checks passed.\n");
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "Date.h"
 #include <ctime>
 #include <cstring>
+#include <cstdio>
 
 namespace DateHelper
 {
@@ -53,4 +54,70 @@ namespace DateHelper
             return 0;
         }
     }
+
+    // Days since 1970-01-01 for a proleptic Gregorian date (Howard Hinnant's days_from_civil)
+    static int daysFromCivil(int year, int month, int day)
+    {
+        year -= month <= 2 ? 1 : 0;
+        int era = (year >= 0 ? year : year - 399) / 400;
+        int yearOfEra = year - era * 400;
+        int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    // Inverse of daysFromCivil (Howard Hinnant's civil_from_days)
+    static void civilFromDays(int days, int &year, int &month, int &day)
+    {
+        days += 719468;
+        int era = (days >= 0 ? days : days - 146096) / 146097;
+        int dayOfEra = days - era * 146097;
+        int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        int monthIndex = (5 * dayOfYear + 2) / 153;
+        day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+        month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+        year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+    }
+
+    bool parseTimestamp(const std::string &text, Timestamp &value)
+    {
+        int year = 0, month = 0, day = 0, hour = 0, minute = 0;
+        int fields = std::sscanf(text.c_str(), "%d-%d-%d %d:%d", &year, &month, &day, &hour, &minute);
+        if (fields != 3 && fields != 5)
+        {
+            return false;
+        }
+        if (month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || hour > 23 || minute < 0 || minute > 59)
+        {
+            return false;
+        }
+        value = daysFromCivil(year, month, day) * MINUTES_PER_DAY + hour * 60 + minute;
+        return true;
+    }
+
+    std::string formatTimestamp(Timestamp value)
+    {
+        if (value == NO_TIMESTAMP)
+        {
+            return "N/A";
+        }
+
+        int days = value >= 0 ? value / MINUTES_PER_DAY : -((-value + MINUTES_PER_DAY - 1) / MINUTES_PER_DAY);
+        int minuteOfDay = value - days * MINUTES_PER_DAY;
+        int year, month, day;
+        civilFromDays(days, year, month, day);
+
+        char buffer[48];
+        std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d",
+                      year, month, day, minuteOfDay / 60, minuteOfDay % 60);
+        return std::string(buffer);
+    }
+
+    Timestamp getCurrentTimestamp()
+    {
+        Timestamp now = 0;
+        parseTimestamp(getCurrentDateTime(), now);
+        return now;
+    }
 }
@@ -2,6 +2,7 @@
 #define DATE_H
 
 #include <string>
+#include <cstdint>
 
 /// Helper functions for date and time operations
 namespace DateHelper
@@ -16,6 +17,30 @@ namespace DateHelper
     /// @return -1 if date1 < date2, 0 if equal, 1 if date1 > date2
     /// @note Assumes dates are in valid YYYY-MM-DD format for correct comparison
     int compareDates(const std::string &date1, const std::string &date2);
+
+    /// Point in time packed as minutes since 1970-01-01 00:00 (local time)
+    typedef int32_t Timestamp;
+
+    /// Sentinel for a date that has not happened yet (e.g. a game not returned);
+    /// it sorts after every real timestamp
+    const Timestamp NO_TIMESTAMP = INT32_MAX;
+
+    const int MINUTES_PER_DAY = 24 * 60;
+
+    /// Parses a date/time string into a timestamp
+    /// @param text Date/time in "YYYY-MM-DD HH:MM" format (the time part is optional)
+    /// @param value Reference to store the parsed timestamp
+    /// @return true if the string is a valid date, false otherwise
+    bool parseTimestamp(const std::string &text, Timestamp &value);
+
+    /// Formats a timestamp as a date/time string
+    /// @param value The timestamp to format
+    /// @return The date/time in "YYYY-MM-DD HH:MM" format, or "N/A" for NO_TIMESTAMP
+    std::string formatTimestamp(Timestamp value);
+
+    /// Gets the current date and time as a timestamp
+    /// @return Minutes since 1970-01-01 00:00 in local time
+    Timestamp getCurrentTimestamp();
 }
 
 // For backward compatibility - global namespace wrappers